@@ -4,6 +4,12 @@
 #include <vector>
 #include <cassert>
 #include <stdexcept>
+#include <cstdint>
+#include <chrono>
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
 
 
 // definition for JNode (Josephus Node)
@@ -79,7 +85,9 @@ void printJosephusList(JNode* head) {
     std::cout << std::endl;
 }
 
-// this function implements the Josephus election algorithm, eliminating every k nodes
+// this function implements the Josephus election algorithm, hitting every k-th node
+// a hit costs the node one of its lives, and the node is eliminated when it has none left
+// (with the default of one life, every hit eliminates)
 // returns the value of the last remaining node
 std::string josephusElection(JNode* head, int k, int startingIndex = 0){
     
@@ -88,6 +96,7 @@ std::string josephusElection(JNode* head, int k, int startingIndex = 0){
     }
 
     JNode* current = head;
+    int remaining = countNodes(head); // counted once, then decremented on every elimination
 
     // skip forward startingIndex times, so that we start the election algorithm from the desired starting index
     for (int i = 0; i < startingIndex; i++){
@@ -101,6 +110,12 @@ std::string josephusElection(JNode* head, int k, int startingIndex = 0){
             current = current->next;
         }
 
+        // the node survives the hit if it has lives left; counting then resumes after it
+        if (--current->next->lives > 0) {
+            current = current->next;
+            continue;
+        }
+
         // if we are about to eliminate the head, then head would point to a deleted node
         // so we update head before eliminating the node
         if (current->next == head) {
@@ -111,13 +126,255 @@ std::string josephusElection(JNode* head, int k, int startingIndex = 0){
         current->next = current->next->next;
 
         delete tmp; // free the memory of the deleted node
+        remaining--;
 
-    } while (countNodes(head) > 1);
+    } while (remaining > 1);
 
     return head->val; // return value of the last remaining node
 
 }
 
+// Josephus engine working on indices 0..n-1 instead of a list of JNodes, so it scales to n = 10^8.
+// it follows the same rules as josephusElection: starting from startingIndex, the k-th person after the
+// current one is eliminated, and counting resumes from the person after them.
+
+// set of the indices 0..n-1 supporting "remove" and "find the r-th remaining index" in O(log n).
+// each index is one bit (64 per word), and a Fenwick tree over the words counts the remaining bits,
+// so the structure takes about n/8 + n/16 bytes (under 20 MB for n = 10^8)
+class RankSelectSet {
+private:
+    std::vector<uint64_t> words;
+    std::vector<int> tree; // 1-based Fenwick tree over the number of set bits in each word
+    int highestStep;       // largest power of two <= number of words, for the Fenwick descent
+
+    // this function returns the position of the r-th (0-based) set bit of w, by halving the search window
+    static int selectBit(uint64_t w, int r) {
+        int pos = 0;
+        for (int width = 32; width > 0; width >>= 1) {
+            int lowCount = __builtin_popcountll((w >> pos) & ((uint64_t(1) << width) - 1));
+            if (r >= lowCount) {
+                r -= lowCount;
+                pos += width;
+            }
+        }
+        return pos;
+    }
+
+public:
+    // creates the set {0, ..., n-1}
+    explicit RankSelectSet(int n) : words((n + 63) / 64, ~uint64_t(0)), tree(words.size() + 1, 0), highestStep(1) {
+        if (n % 64 != 0) {
+            words.back() = (uint64_t(1) << (n % 64)) - 1;
+        }
+        // linear-time Fenwick construction: each node passes its total on to its parent
+        for (size_t i = 1; i < tree.size(); i++) {
+            tree[i] += __builtin_popcountll(words[i - 1]);
+            size_t parent = i + (i & (~i + 1));
+            if (parent < tree.size()) {
+                tree[parent] += tree[i];
+            }
+        }
+        while (static_cast<size_t>(highestStep) * 2 < tree.size()) {
+            highestStep *= 2;
+        }
+    }
+
+    // this function returns the r-th (0-based) smallest index still in the set; r must be < the set size
+    int select(int r) const {
+        // Fenwick descent: find the word holding the r-th bit, keeping r relative to that word
+        size_t word = 0;
+        for (size_t step = highestStep; step > 0; step >>= 1) {
+            if (word + step < tree.size() && tree[word + step] <= r) {
+                word += step;
+                r -= tree[word];
+            }
+        }
+        return static_cast<int>(word * 64) + selectBit(words[word], r);
+    }
+
+    // this function removes index i, which must be in the set
+    void remove(int i) {
+        words[i / 64] &= ~(uint64_t(1) << (i % 64));
+        for (size_t node = i / 64 + 1; node < tree.size(); node += node & (~node + 1)) {
+            tree[node]--;
+        }
+    }
+};
+
+// this function returns the indices of all n participants in the order they are eliminated
+// (the last one is the winner), in O(n log n) for any k
+// @throws invalid_argument if n < 1, k < 1 or startingIndex < 0
+std::vector<int> josephusEliminationOrder(int n, int k, int startingIndex = 0) {
+    if (n < 1 || k < 1 || startingIndex < 0) {
+        throw std::invalid_argument("josephusEliminationOrder() needs n >= 1, k >= 1 and startingIndex >= 0");
+    }
+
+    RankSelectSet remaining(n);
+    std::vector<int> order;
+    order.reserve(n);
+
+    // rank (among the remaining participants) of the next one to eliminate; after an elimination at rank r,
+    // the following participant takes rank r, so the next elimination is k - 1 ranks further on
+    int64_t rank = (startingIndex % n + static_cast<int64_t>(k)) % n;
+    for (int alive = n; alive > 0; alive--) {
+        int idx = remaining.select(static_cast<int>(rank));
+        remaining.remove(idx);
+        order.push_back(idx);
+        if (alive > 1) {
+            rank = (rank + k - 1) % (alive - 1);
+        }
+    }
+    return order;
+}
+
+// this function returns the index of the winner only, in O(1) memory, using the recurrence
+// J(1) = 0, J(m) = (J(m-1) + k) mod m, which is O(n) - or, when k is small compared to n, the variant which
+// eliminates a whole lap (m / k participants) per step, which is O(k log n)
+// @throws invalid_argument if n < 1, k < 1 or startingIndex < 0
+int josephusWinner(int n, int k, int startingIndex = 0) {
+    if (n < 1 || k < 1 || startingIndex < 0) {
+        throw std::invalid_argument("josephusWinner() needs n >= 1, k >= 1 and startingIndex >= 0");
+    }
+
+    int64_t winner; // winner when counting starts at index 0 (so index k-1 is eliminated first)
+    if (k == 1) {
+        winner = n - 1;
+    }
+    else if (static_cast<int64_t>(k) * (64 - __builtin_clzll(n)) < n) {
+        // a lap removes every k-th participant at once; record the sizes on the way down
+        std::vector<int> sizes;
+        int64_t m = n;
+        while (m >= k) {
+            sizes.push_back(static_cast<int>(m));
+            m -= m / k;
+        }
+        winner = 0;
+        for (int64_t i = 2; i <= m; i++) {
+            winner = (winner + k) % i;
+        }
+        // map the winner among the survivors of a lap back to an index before that lap
+        for (size_t i = sizes.size(); i-- > 0;) {
+            int64_t size = sizes[i];
+            winner -= size % k;
+            if (winner < 0) {
+                winner += size;
+            }
+            else {
+                winner += winner / (k - 1);
+            }
+        }
+    }
+    else {
+        winner = 0;
+        for (int64_t i = 2; i <= n; i++) {
+            winner = (winner + k) % i;
+        }
+    }
+
+    // josephusElection starts counting at the participant after startingIndex
+    return static_cast<int>((winner + startingIndex % n + 1) % n);
+}
+
+// multi-life simulation: participant i starts with lives[i] lives, and hit number h uses the step
+// steps[h % steps.size()]. a hit costs one life; a participant is eliminated when it has none left.
+// counting resumes after the participant that was hit, as in josephusElection.
+// this takes O(H log n) for H = the total number of lives, using RankSelectSet instead of walking nodes.
+// onEliminate(idx) is called for every eliminated participant, in order; returns the winner's index.
+// @throws invalid_argument if lives is empty or has a non-positive entry, steps is empty or has a step < 1,
+//         or startingIndex < 0
+template<typename OnEliminate>
+int simulateMultiLife(std::vector<int> lives, const std::vector<int>& steps, int startingIndex, OnEliminate onEliminate) {
+    int n = static_cast<int>(lives.size());
+    if (n < 1 || steps.empty() || startingIndex < 0) {
+        throw std::invalid_argument("simulateMultiLife() needs participants, steps and startingIndex >= 0");
+    }
+    for (int l : lives) {
+        if (l < 1) { throw std::invalid_argument("every participant needs at least one life"); }
+    }
+    for (int k : steps) {
+        if (k < 1) { throw std::invalid_argument("every step must be at least 1"); }
+    }
+
+    RankSelectSet remaining(n);
+    size_t round = 0;
+    int64_t rank = (startingIndex % n + static_cast<int64_t>(steps[0])) % n;
+    for (int alive = n; alive > 1;) {
+        int idx = remaining.select(static_cast<int>(rank));
+        int64_t nextStep = steps[++round % steps.size()];
+        if (--lives[idx] > 0) {
+            // the participant stays at this rank, and counting starts with the one after it
+            rank = (rank + nextStep) % alive;
+            continue;
+        }
+        remaining.remove(idx);
+        onEliminate(idx);
+        alive--;
+        // the participant after the eliminated one has moved down to its rank
+        rank = (rank + nextStep - 1) % alive;
+    }
+    return remaining.select(0);
+}
+
+// this function returns the indices of the eliminated participants, in order, followed by the winner
+std::vector<int> josephusMultiLifeOrder(const std::vector<int>& lives, const std::vector<int>& steps, int startingIndex = 0) {
+    std::vector<int> order;
+    order.reserve(lives.size());
+    int winner = simulateMultiLife(lives, steps, startingIndex, [&order](int idx) { order.push_back(idx); });
+    order.push_back(winner);
+    return order;
+}
+
+// one configuration of a batch: n participants with `lives` lives each, hit every k-th
+struct JosephusConfig {
+    int n;
+    int k;
+    int lives;
+    int startingIndex;
+};
+
+// this function simulates every configuration and returns their winners, running the configurations
+// on up to `threads` threads (0 = one per hardware thread); each thread takes the next unclaimed configuration
+std::vector<int> josephusBatchWinners(const std::vector<JosephusConfig>& configs, unsigned threads = 0) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = std::min<unsigned>(threads, static_cast<unsigned>(configs.size()));
+
+    std::vector<int> winners(configs.size());
+    std::vector<std::exception_ptr> errors(configs.size());
+    std::atomic<size_t> nextConfig(0);
+    auto worker = [&]() {
+        for (size_t i = nextConfig++; i < configs.size(); i = nextConfig++) {
+            const JosephusConfig& config = configs[i];
+            try {
+                if (config.lives == 1) {
+                    winners[i] = josephusWinner(config.n, config.k, config.startingIndex);
+                }
+                else {
+                    winners[i] = simulateMultiLife(std::vector<int>(std::max(config.n, 0), config.lives), {config.k},
+                                                   config.startingIndex, [](int) {});
+                }
+            }
+            catch (...) {
+                errors[i] = std::current_exception();
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threads; t++) {
+        pool.emplace_back(worker);
+    }
+    worker(); // the calling thread works too
+    for (std::thread& t : pool) {
+        t.join();
+    }
+    for (const std::exception_ptr& error : errors) {
+        if (error) { std::rethrow_exception(error); }
+    }
+    return winners;
+}
+
 int main()
 {
     std::vector<std::string> names = {"Etienne", "Luca", "Emre", "Akkshay", "Kazy", "Noe"};
@@ -129,6 +386,50 @@ int main()
 
     std::string winner = josephusElection(jos, 3, 0);
     std::cout << winner << std::endl;
+
+    // the index-based engine agrees with the list-based election
+    std::vector<int> order = josephusEliminationOrder(static_cast<int>(names.size()), 3, 0);
+    std::cout << "elimination order:";
+    for (int idx : order) {
+        std::cout << " " << names[idx];
+    }
+    std::cout << " | winner: " << names[josephusWinner(static_cast<int>(names.size()), 3, 0)] << std::endl;
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<int> bigOrder = josephusEliminationOrder(10000000, 1000, 0);
+    auto ordered = std::chrono::steady_clock::now();
+    int bigWinner = josephusWinner(100000000, 1000, 0);
+    auto linear = std::chrono::steady_clock::now();
+    int smallKWinner = josephusWinner(100000000, 3, 0);
+    auto laps = std::chrono::steady_clock::now();
+
+    std::cout << "full order, n = 10^7, k = 1000: " << std::chrono::duration<double, std::milli>(ordered - start).count()
+              << " ms (winner " << bigOrder.back() << ")" << std::endl;
+    std::cout << "winner only, n = 10^8, k = 1000: " << std::chrono::duration<double, std::milli>(linear - ordered).count()
+              << " ms (winner " << bigWinner << ")" << std::endl;
+    std::cout << "winner only, n = 10^8, k = 3: " << std::chrono::duration<double, std::micro>(laps - linear).count()
+              << " us (winner " << smallKWinner << ")" << std::endl;
+
+    // multi-life: Luca has three lives, the step alternates between 2 and 3
+    std::vector<int> lives = {1, 3, 1, 1, 1, 1};
+    std::vector<int> lifeOrder = josephusMultiLifeOrder(lives, {2, 3});
+    std::cout << "multi-life elimination order:";
+    for (int idx : lifeOrder) {
+        std::cout << " " << names[idx];
+    }
+    std::cout << std::endl;
+
+    std::vector<JosephusConfig> configs = {{10000000, 3, 2, 0}};
+    for (int k = 2; k < 9; k++) {
+        configs.push_back({1000000, k, 1 + k % 3, k});
+    }
+    auto batchStart = std::chrono::steady_clock::now();
+    std::vector<int> batchWinners = josephusBatchWinners(configs);
+    auto batchEnd = std::chrono::steady_clock::now();
+    std::cout << "batch of " << configs.size() << " configurations (up to 10^7 participants, 2 * 10^7 hits) on "
+              << std::max(1u, std::thread::hardware_concurrency()) << " thread(s): "
+              << std::chrono::duration<double, std::milli>(batchEnd - batchStart).count() << " ms, first winner "
+              << batchWinners[0] << std::endl;
 }
 
 
@@ -0,0 +1,285 @@
+/**
+ * An append-only dynamic array for many concurrent producers.
+ * Producers reserve indices with a single fetch_add, so appends never take a lock
+ * (a producer only waits when its block is still being allocated by another producer).
+ * Storage is segmented like SegmentedVec (blocks whose sizes double), so growing never
+ * moves an element. Each slot has a flag which is set (release) once its element has been
+ * constructed; readers check it (acquire), so reading a published element is wait-free.
+ */
+
+#include <stdexcept>
+#include <iostream>
+#include <vector>
+#include <string>
+#include <utility>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <new>
+#include <cstdint>
+
+
+template<typename T>
+class ConcurrentVec {
+private:
+    struct Slot {
+        std::atomic<bool> published;
+        alignas(T) unsigned char storage[sizeof(T)];
+
+        Slot() : published(false) {}
+        T* value() { return reinterpret_cast<T*>(storage); }
+        const T* value() const { return reinterpret_cast<const T*>(storage); }
+    };
+
+    static const size_t FIRST_BLOCK_LOG2 = 6;
+    static const size_t FIRST_BLOCK = size_t(1) << FIRST_BLOCK_LOG2;
+    static const size_t MAX_BLOCKS = 64 - FIRST_BLOCK_LOG2;
+
+    std::atomic<size_t> m_reserved; // number of indices handed out so far
+    std::atomic<Slot*> m_blocks[MAX_BLOCKS];
+    std::atomic<bool> m_alloc_failed[MAX_BLOCKS]; // set if the first allocation of a block threw
+
+    static size_t block_capacity(size_t block) { return FIRST_BLOCK << block; }
+
+    // Maps an index to its block and the offset within that block (see SegmentedVec::locate).
+    static void locate(size_t idx, size_t& block, size_t& offset) {
+        size_t shifted = idx + FIRST_BLOCK;
+        size_t high_bit = 63 - __builtin_clzll(shifted);
+        block = high_bit - FIRST_BLOCK_LOG2;
+        offset = shifted - (size_t(1) << high_bit);
+    }
+
+    // Returns block b for a thread that reserved the given offset in it.
+    // Exactly one thread reserves offset 0 of each block, and that thread allocates it; any other
+    // thread that gets there first yields until the block is installed. (Letting every thread race
+    // to allocate would waste a whole, possibly huge, block per losing thread.)
+    // If that allocation throws (or that thread gives up before reaching offset 0, see abandon_blocks),
+    // the block is marked as failed and the waiting threads allocate it themselves, the first to install
+    // it winning, so that they do not wait forever.
+    // @throws Throws std::bad_alloc if the block cannot be allocated
+    Slot* block_for(size_t b, size_t offset) {
+        Slot* block = m_blocks[b].load(std::memory_order_acquire);
+        if (block != nullptr) { return block; }
+
+        if (offset == 0) {
+            try {
+                block = new Slot[block_capacity(b)];
+            }
+            catch (...) {
+                m_alloc_failed[b].store(true, std::memory_order_release);
+                throw;
+            }
+            m_blocks[b].store(block, std::memory_order_release);
+            return block;
+        }
+        while ((block = m_blocks[b].load(std::memory_order_acquire)) == nullptr) {
+            if (m_alloc_failed[b].load(std::memory_order_acquire)) {
+                Slot* fresh = new Slot[block_capacity(b)];
+                if (m_blocks[b].compare_exchange_strong(block, fresh, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                    return fresh;
+                }
+                delete[] fresh; // another waiter installed it first; block now holds theirs
+                return block;
+            }
+            std::this_thread::yield();
+        }
+        return block;
+    }
+
+    // Called when a producer gives up on its reserved indices [from, end): marks every block that starts
+    // in that range as failed, so that producers holding other indices in it allocate the block
+    // themselves instead of waiting for this one.
+    void abandon_blocks(size_t from, size_t end) {
+        for (size_t b = 0 ; b < MAX_BLOCKS ; b++) {
+            size_t start = block_capacity(b) - FIRST_BLOCK; // index at offset 0 of block b
+            if (start >= end) { break; }
+            if (start >= from) { m_alloc_failed[b].store(true, std::memory_order_release); }
+        }
+    }
+
+    // @returns Returns the slot at idx if its block exists, nullptr otherwise
+    const Slot* find_slot(size_t idx) const {
+        size_t block, offset;
+        locate(idx, block, offset);
+        const Slot* slots = m_blocks[block].load(std::memory_order_acquire);
+        return slots == nullptr ? nullptr : slots + offset;
+    }
+
+    // Constructs the element at a reserved index and publishes it to readers
+    template<typename... Args>
+    void construct_at(size_t idx, Args&&... args) {
+        size_t block, offset;
+        locate(idx, block, offset);
+        Slot& slot = block_for(block, offset)[offset];
+        new (slot.value()) T(std::forward<Args>(args)...);
+        slot.published.store(true, std::memory_order_release);
+    }
+
+public:
+    ConcurrentVec() : m_reserved(0), m_blocks(), m_alloc_failed() {}
+
+    // Must not run concurrently with any other member function.
+    ~ConcurrentVec() {
+        for (size_t b = 0 ; b < MAX_BLOCKS ; b++) {
+            Slot* slots = m_blocks[b].load(std::memory_order_relaxed);
+            if (slots == nullptr) { continue; }
+            for (size_t i = 0 ; i < block_capacity(b) ; i++) {
+                if (slots[i].published.load(std::memory_order_relaxed)) { slots[i].value()->~T(); }
+            }
+            delete[] slots;
+        }
+    }
+
+    // Concurrent containers are shared by reference, not copied.
+    ConcurrentVec(const ConcurrentVec&) = delete;
+    ConcurrentVec& operator=(const ConcurrentVec&) = delete;
+
+    // Appends an element. Safe to call from any number of threads at once.
+    // @returns Returns the index the element was stored at
+    size_t push_back(const T& val) {
+        return emplace_back(val);
+    }
+
+    size_t push_back(T&& val) {
+        return emplace_back(std::move(val));
+    }
+
+    // Constructs an element in place at a newly reserved index.
+    // @returns Returns the index the element was stored at
+    template<typename... Args>
+    size_t emplace_back(Args&&... args) {
+        size_t idx = m_reserved.fetch_add(1, std::memory_order_relaxed);
+        construct_at(idx, std::forward<Args>(args)...);
+        return idx;
+    }
+
+    // Appends n elements as one contiguous run of indices, reserved with a single fetch_add
+    // (cheaper than n push_backs when many producers contend for the counter).
+    // If a copy throws, the elements before it stay published and the rest of the run is left empty.
+    // @returns Returns the index of the first appended element
+    size_t append(const T* values, size_t n) {
+        size_t first = m_reserved.fetch_add(n, std::memory_order_relaxed);
+        size_t i = 0;
+        try {
+            for (; i < n ; i++) {
+                construct_at(first + i, values[i]);
+            }
+        }
+        catch (...) {
+            abandon_blocks(first + i, first + n);
+            throw;
+        }
+        return first;
+    }
+
+    // @returns Returns the number of indices handed out so far. Elements below this index
+    // may still be under construction; use try_get / is_published to read them safely.
+    size_t size() const {
+        return m_reserved.load(std::memory_order_acquire);
+    }
+
+    // @returns Returns true if the element at idx has been constructed and may be read
+    bool is_published(size_t idx) const {
+        if (idx >= size()) { return false; }
+        const Slot* slot = find_slot(idx);
+        return slot != nullptr && slot->published.load(std::memory_order_acquire);
+    }
+
+    // Wait-free read of a published element.
+    // @returns Returns true and copies the element into out if it is published, false otherwise
+    bool try_get(size_t idx, T& out) const {
+        if (!is_published(idx)) { return false; }
+        out = *find_slot(idx)->value();
+        return true;
+    }
+
+    // @return Returns the value at index i.
+    // @throws Throws std::out_of_range if no element has been published at i.
+    T at(size_t i) const {
+        if (!is_published(i)) {
+            throw std::out_of_range("Attempting to access elements which are out of range or not yet published.");
+        }
+        return *find_slot(i)->value();
+    }
+
+    // @returns Returns a reference to the element at idx, which must be published (unchecked).
+    // Elements never move, so the reference stays valid for the lifetime of the vector.
+    const T& operator[](size_t idx) const {
+        return *find_slot(idx)->value();
+    }
+};
+
+
+// Runs `threads` producers which together append total_items elements, either one push_back
+// at a time or in batches, and reports the throughput.
+void benchmarkProducers(size_t threads, size_t total_items, size_t batch) {
+    ConcurrentVec<uint64_t> vec;
+    size_t per_thread = total_items / threads;
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> producers;
+    for (size_t t = 0 ; t < threads ; t++) {
+        producers.emplace_back([&vec, per_thread, batch, t] {
+            std::vector<uint64_t> values(batch);
+            for (size_t i = 0 ; i < per_thread ; i += batch) {
+                if (batch == 1) {
+                    vec.push_back(t * per_thread + i);
+                    continue;
+                }
+                for (size_t j = 0 ; j < batch ; j++) { values[j] = t * per_thread + i + j; }
+                vec.append(values.data(), batch);
+            }
+        });
+    }
+    for (std::thread& p : producers) { p.join(); }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    size_t unpublished = 0;
+    for (size_t i = 0 ; i < vec.size() ; i++) {
+        unpublished += !vec.is_published(i);
+    }
+    std::cout << threads << " producer(s), batch " << batch << ": "
+              << vec.size() / seconds / 1e6 << " M appends/s"
+              << (unpublished == 0 ? "" : " (UNPUBLISHED SLOTS)") << std::endl;
+}
+
+// Baseline: the same workload through a mutex-guarded std::vector
+void benchmarkMutexBaseline(size_t threads, size_t total_items) {
+    std::vector<uint64_t> vec;
+    std::mutex lock;
+    size_t per_thread = total_items / threads;
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> producers;
+    for (size_t t = 0 ; t < threads ; t++) {
+        producers.emplace_back([&, t] {
+            for (size_t i = 0 ; i < per_thread ; i++) {
+                std::lock_guard<std::mutex> guard(lock);
+                vec.push_back(t * per_thread + i);
+            }
+        });
+    }
+    for (std::thread& p : producers) { p.join(); }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << threads << " producer(s), mutex + std::vector: " << vec.size() / seconds / 1e6 << " M appends/s" << std::endl;
+}
+
+
+int main() {
+    ConcurrentVec<std::string> names;
+    size_t idx = names.push_back("first");
+    names.emplace_back(3, 'x');
+    std::string out;
+    std::cout << "try_get(" << idx << ") = " << names.try_get(idx, out) << " " << out
+              << " | at(1) = " << names.at(1) << " | is_published(2) = " << names.is_published(2) << std::endl;
+
+    std::cout << "hardware threads: " << std::thread::hardware_concurrency() << std::endl;
+    const size_t TOTAL = 1 << 24;
+    for (size_t threads : {1, 2, 4, 8, 16, 32}) {
+        benchmarkMutexBaseline(threads, TOTAL);
+        benchmarkProducers(threads, TOTAL, 1);
+        benchmarkProducers(threads, TOTAL, 64);
+    }
+}
@@ -9,6 +9,26 @@
 #include <vector>
 #include <utility>
 #include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <memory>
+#include <memory_resource>
+#include <cstring>
+#include <type_traits>
+#include <cstdint>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
 
 // computes the smallest power of two not less than n for 32-bit unsigned integers
 constexpr unsigned int bit_ceil(unsigned int n) {
@@ -23,38 +43,506 @@ constexpr unsigned int bit_ceil(unsigned int n) {
 }
 
 
+// Search kernels used by Vec::contains, find_first and find_all.
+// Integral and floating-point elements are compared 16-32 bytes at a time with SSE4.1 / AVX2,
+// picked at runtime from what the CPU supports; anything else uses the scalar loops.
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define VEC_X86_SIMD 1
+#endif
+
+// @returns Returns the index of the first element equal to val, or n if there is none
+template<typename T>
+size_t find_first_scalar(const T* data, size_t n, const T& val) {
+    for (size_t i = 0 ; i < n ; i++) {
+        if (data[i] == val) { return i; }
+    }
+    return n;
+}
+
+// Appends the index of every element equal to val to out, offset by base
+template<typename T>
+void find_all_scalar(const T* data, size_t n, const T& val, std::vector<size_t>& out, size_t base = 0) {
+    for (size_t i = 0 ; i < n ; i++) {
+        if (data[i] == val) { out.push_back(base + i); }
+    }
+}
+
+// @returns Returns the number of elements equal to val
+template<typename T>
+size_t count_scalar(const T* data, size_t n, const T& val) {
+    size_t counter = 0;
+    for (size_t i = 0 ; i < n ; i++) {
+        counter += data[i] == val;
+    }
+    return counter;
+}
+
+// True for the element types the SIMD kernels handle (bool and long double are left to the scalar loops)
+template<typename T>
+constexpr bool is_simd_searchable() {
+    return std::is_arithmetic<T>::value && !std::is_same<T, bool>::value
+        && (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8)
+        && (!std::is_floating_point<T>::value || std::is_same<T, float>::value || std::is_same<T, double>::value);
+}
+
+enum class SimdLevel { SCALAR, SSE41, AVX2 };
+
+// @returns Returns the widest instruction set the search kernels can use on this CPU (detected once)
+inline SimdLevel simd_level() {
+#ifdef VEC_X86_SIMD
+    static const SimdLevel level = __builtin_cpu_supports("avx2") ? SimdLevel::AVX2
+                                 : __builtin_cpu_supports("sse4.1") ? SimdLevel::SSE41
+                                 : SimdLevel::SCALAR;
+    return level;
+#else
+    return SimdLevel::SCALAR;
+#endif
+}
+
+#ifdef VEC_X86_SIMD
+
+// Lane-wise equality of two AVX2 registers holding elements of type T.
+// Every byte of an equal lane is set, so movemask gives sizeof(T) bits per element.
+template<typename T>
+__attribute__((target("avx2"))) inline __m256i eq_avx2(__m256i a, __m256i b) {
+    if constexpr (std::is_same<T, float>::value) {
+        return _mm256_castps_si256(_mm256_cmp_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b), _CMP_EQ_OQ));
+    }
+    else if constexpr (std::is_same<T, double>::value) {
+        return _mm256_castpd_si256(_mm256_cmp_pd(_mm256_castsi256_pd(a), _mm256_castsi256_pd(b), _CMP_EQ_OQ));
+    }
+    else if constexpr (sizeof(T) == 1) { return _mm256_cmpeq_epi8(a, b); }
+    else if constexpr (sizeof(T) == 2) { return _mm256_cmpeq_epi16(a, b); }
+    else if constexpr (sizeof(T) == 4) { return _mm256_cmpeq_epi32(a, b); }
+    else { return _mm256_cmpeq_epi64(a, b); }
+}
+
+// AVX2 register with val in every lane
 template<typename T>
-class Vec {
+__attribute__((target("avx2"))) inline __m256i splat_avx2(T val) {
+    alignas(32) T lanes[32 / sizeof(T)];
+    for (T& lane : lanes) { lane = val; }
+    return _mm256_load_si256(reinterpret_cast<const __m256i*>(lanes));
+}
+
+template<typename T>
+__attribute__((target("avx2"))) size_t find_first_avx2(const T* data, size_t n, const T& val) {
+    const size_t LANES = 32 / sizeof(T);
+    const __m256i needle = splat_avx2(val);
+    size_t i = 0;
+
+    // Four registers (128 bytes) per iteration, with a single branch for the common no-match case
+    for ( ; i + 4 * LANES <= n ; i += 4 * LANES) {
+        const __m256i* p = reinterpret_cast<const __m256i*>(data + i);
+        __m256i e0 = eq_avx2<T>(_mm256_loadu_si256(p), needle);
+        __m256i e1 = eq_avx2<T>(_mm256_loadu_si256(p + 1), needle);
+        __m256i e2 = eq_avx2<T>(_mm256_loadu_si256(p + 2), needle);
+        __m256i e3 = eq_avx2<T>(_mm256_loadu_si256(p + 3), needle);
+        __m256i any = _mm256_or_si256(_mm256_or_si256(e0, e1), _mm256_or_si256(e2, e3));
+        if (!_mm256_testz_si256(any, any)) {
+            const __m256i hits[4] = {e0, e1, e2, e3};
+            for (size_t r = 0 ; r < 4 ; r++) {
+                uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(hits[r]));
+                if (mask != 0) { return i + r * LANES + __builtin_ctz(mask) / sizeof(T); }
+            }
+        }
+    }
+    for ( ; i + LANES <= n ; i += LANES) {
+        __m256i e = eq_avx2<T>(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)), needle);
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(e));
+        if (mask != 0) { return i + __builtin_ctz(mask) / sizeof(T); }
+    }
+    return i + find_first_scalar(data + i, n - i, val);
+}
+
+template<typename T>
+__attribute__((target("avx2,popcnt"))) void find_all_avx2(const T* data, size_t n, const T& val, std::vector<size_t>& out, size_t base = 0) {
+    const size_t LANES = 32 / sizeof(T);
+    const uint32_t LANE_BITS = (1u << sizeof(T)) - 1; // movemask bits belonging to one element
+    const __m256i needle = splat_avx2(val);
+    size_t i = 0;
+
+    for ( ; i + LANES <= n ; i += LANES) {
+        __m256i e = eq_avx2<T>(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)), needle);
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(e));
+        if (mask == 0) { continue; }
+
+        // popcount sizes the output once, then each set lane writes its index
+        size_t pos = out.size();
+        out.resize(pos + __builtin_popcount(mask) / sizeof(T));
+        size_t* dst = out.data() + pos;
+        while (mask != 0) {
+            unsigned bit = __builtin_ctz(mask);
+            *dst++ = base + i + bit / sizeof(T);
+            mask &= ~(LANE_BITS << bit);
+        }
+    }
+    find_all_scalar(data + i, n - i, val, out, base + i);
+}
+
+template<typename T>
+__attribute__((target("avx2,popcnt"))) size_t count_avx2(const T* data, size_t n, const T& val) {
+    const size_t LANES = 32 / sizeof(T);
+    const __m256i needle = splat_avx2(val);
+    size_t matching_bytes = 0;
+    size_t i = 0;
+    for ( ; i + LANES <= n ; i += LANES) {
+        __m256i e = eq_avx2<T>(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i)), needle);
+        matching_bytes += __builtin_popcount(static_cast<uint32_t>(_mm256_movemask_epi8(e)));
+    }
+    return matching_bytes / sizeof(T) + count_scalar(data + i, n - i, val);
+}
+
+// SSE4.1 versions of the above, 16 bytes at a time (SSE4.1 is needed for 64-bit compares)
+template<typename T>
+__attribute__((target("sse4.1"))) inline __m128i eq_sse41(__m128i a, __m128i b) {
+    if constexpr (std::is_same<T, float>::value) {
+        return _mm_castps_si128(_mm_cmpeq_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b)));
+    }
+    else if constexpr (std::is_same<T, double>::value) {
+        return _mm_castpd_si128(_mm_cmpeq_pd(_mm_castsi128_pd(a), _mm_castsi128_pd(b)));
+    }
+    else if constexpr (sizeof(T) == 1) { return _mm_cmpeq_epi8(a, b); }
+    else if constexpr (sizeof(T) == 2) { return _mm_cmpeq_epi16(a, b); }
+    else if constexpr (sizeof(T) == 4) { return _mm_cmpeq_epi32(a, b); }
+    else { return _mm_cmpeq_epi64(a, b); }
+}
+
+template<typename T>
+__attribute__((target("sse4.1"))) inline __m128i splat_sse41(T val) {
+    alignas(16) T lanes[16 / sizeof(T)];
+    for (T& lane : lanes) { lane = val; }
+    return _mm_load_si128(reinterpret_cast<const __m128i*>(lanes));
+}
+
+template<typename T>
+__attribute__((target("sse4.1"))) size_t find_first_sse41(const T* data, size_t n, const T& val) {
+    const size_t LANES = 16 / sizeof(T);
+    const __m128i needle = splat_sse41(val);
+    size_t i = 0;
+    for ( ; i + LANES <= n ; i += LANES) {
+        __m128i e = eq_sse41<T>(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)), needle);
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(e));
+        if (mask != 0) { return i + __builtin_ctz(mask) / sizeof(T); }
+    }
+    return i + find_first_scalar(data + i, n - i, val);
+}
+
+template<typename T>
+__attribute__((target("sse4.1,popcnt"))) void find_all_sse41(const T* data, size_t n, const T& val, std::vector<size_t>& out, size_t base = 0) {
+    const size_t LANES = 16 / sizeof(T);
+    const uint32_t LANE_BITS = (1u << sizeof(T)) - 1;
+    const __m128i needle = splat_sse41(val);
+    size_t i = 0;
+    for ( ; i + LANES <= n ; i += LANES) {
+        __m128i e = eq_sse41<T>(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)), needle);
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(e));
+        if (mask == 0) { continue; }
+
+        size_t pos = out.size();
+        out.resize(pos + __builtin_popcount(mask) / sizeof(T));
+        size_t* dst = out.data() + pos;
+        while (mask != 0) {
+            unsigned bit = __builtin_ctz(mask);
+            *dst++ = base + i + bit / sizeof(T);
+            mask &= ~(LANE_BITS << bit);
+        }
+    }
+    find_all_scalar(data + i, n - i, val, out, base + i);
+}
+
+template<typename T>
+__attribute__((target("sse4.1,popcnt"))) size_t count_sse41(const T* data, size_t n, const T& val) {
+    const size_t LANES = 16 / sizeof(T);
+    const __m128i needle = splat_sse41(val);
+    size_t matching_bytes = 0;
+    size_t i = 0;
+    for ( ; i + LANES <= n ; i += LANES) {
+        __m128i e = eq_sse41<T>(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i)), needle);
+        matching_bytes += __builtin_popcount(static_cast<uint32_t>(_mm_movemask_epi8(e)));
+    }
+    return matching_bytes / sizeof(T) + count_scalar(data + i, n - i, val);
+}
+
+#endif // VEC_X86_SIMD
+
+// @returns Returns the index of the first element equal to val, or n if there is none
+template<typename T>
+size_t find_first_kernel(const T* data, size_t n, const T& val) {
+#ifdef VEC_X86_SIMD
+    if constexpr (is_simd_searchable<T>()) {
+        switch (simd_level()) {
+            case SimdLevel::AVX2: return find_first_avx2(data, n, val);
+            case SimdLevel::SSE41: return find_first_sse41(data, n, val);
+            case SimdLevel::SCALAR: break;
+        }
+    }
+#endif
+    return find_first_scalar(data, n, val);
+}
+
+// Appends the index (offset by base) of every element equal to val to out, in increasing order
+template<typename T>
+void find_all_kernel(const T* data, size_t n, const T& val, std::vector<size_t>& out, size_t base = 0) {
+#ifdef VEC_X86_SIMD
+    if constexpr (is_simd_searchable<T>()) {
+        switch (simd_level()) {
+            case SimdLevel::AVX2: find_all_avx2(data, n, val, out, base); return;
+            case SimdLevel::SSE41: find_all_sse41(data, n, val, out, base); return;
+            case SimdLevel::SCALAR: break;
+        }
+    }
+#endif
+    find_all_scalar(data, n, val, out, base);
+}
+
+// @returns Returns the number of elements equal to val
+template<typename T>
+size_t count_kernel(const T* data, size_t n, const T& val) {
+#ifdef VEC_X86_SIMD
+    if constexpr (is_simd_searchable<T>()) {
+        switch (simd_level()) {
+            case SimdLevel::AVX2: return count_avx2(data, n, val);
+            case SimdLevel::SSE41: return count_sse41(data, n, val);
+            case SimdLevel::SCALAR: break;
+        }
+    }
+#endif
+    return count_scalar(data, n, val);
+}
+
+
+// A fixed set of worker threads (one per hardware thread, minus the caller) for splitting
+// large scans. run() hands out chunk numbers from an atomic counter to the workers and the
+// calling thread, and returns once every chunk is done. One job runs at a time.
+class ScanPool {
+private:
+    std::vector<std::thread> m_workers;
+    std::mutex m_run_lock; // serialises run() calls
+    std::mutex m_lock;
+    std::condition_variable m_wake;
+    std::condition_variable m_done;
+    const std::function<void(size_t)>* m_job;
+    size_t m_chunks;
+    std::atomic<size_t> m_next_chunk;
+    size_t m_generation;
+    size_t m_active; // workers currently running chunks of the job
+    bool m_stop;
+
+    void worker_loop() {
+        size_t seen_generation = 0;
+        std::unique_lock<std::mutex> lock(m_lock);
+        while (true) {
+            m_wake.wait(lock, [&] { return m_stop || (m_job != nullptr && m_generation != seen_generation); });
+            if (m_stop) { return; }
+            seen_generation = m_generation;
+            const std::function<void(size_t)>& job = *m_job;
+            size_t chunks = m_chunks;
+            m_active++;
+            lock.unlock();
+
+            for (size_t c = m_next_chunk.fetch_add(1) ; c < chunks ; c = m_next_chunk.fetch_add(1)) {
+                job(c);
+            }
+
+            lock.lock();
+            if (--m_active == 0) { m_done.notify_all(); }
+        }
+    }
+
+public:
+    explicit ScanPool(size_t workers)
+        : m_job(nullptr), m_chunks(0), m_next_chunk(0), m_generation(0), m_active(0), m_stop(false) {
+        for (size_t i = 0 ; i < workers ; i++) {
+            m_workers.emplace_back([this] { worker_loop(); });
+        }
+    }
+
+    ~ScanPool() {
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            m_stop = true;
+        }
+        m_wake.notify_all();
+        for (std::thread& worker : m_workers) { worker.join(); }
+    }
+
+    ScanPool(const ScanPool&) = delete;
+    ScanPool& operator=(const ScanPool&) = delete;
+
+    // The pool shared by all Vecs, created on first use
+    static ScanPool& shared() {
+        static ScanPool pool(std::max(1u, std::thread::hardware_concurrency()) - 1);
+        return pool;
+    }
+
+    // @returns Returns the number of threads that run a job (the workers plus the caller)
+    size_t threads() const { return m_workers.size() + 1; }
+
+    // Calls job(c) for every c in [0, chunks), spread over the pool and the calling thread
+    void run(size_t chunks, const std::function<void(size_t)>& job) {
+        std::lock_guard<std::mutex> one_job(m_run_lock);
+        {
+            std::lock_guard<std::mutex> lock(m_lock);
+            m_job = &job;
+            m_chunks = chunks;
+            m_next_chunk = 0;
+            m_generation++;
+        }
+        m_wake.notify_all();
+
+        for (size_t c = m_next_chunk.fetch_add(1) ; c < chunks ; c = m_next_chunk.fetch_add(1)) {
+            job(c);
+        }
+
+        // Every chunk has been claimed; wait for the workers still running theirs.
+        // Workers that had not picked up the job yet see m_job == nullptr and keep sleeping.
+        std::unique_lock<std::mutex> lock(m_lock);
+        m_job = nullptr;
+        m_done.wait(lock, [this] { return m_active == 0; });
+    }
+};
+
+// Scans over at least this many elements are split across the ScanPool; smaller ones stay on
+// the calling thread, where the hand-off would cost more than it saves.
+inline size_t& parallel_scan_threshold() {
+    static size_t threshold = size_t(1) << 20;
+    return threshold;
+}
+
+// Splits [0, n) into about four chunks per pool thread (for load balancing)
+// and calls scan(chunk_number, first, count) for each of them in parallel.
+// @returns Returns the number of chunks
+template<typename Scan>
+size_t parallel_chunks(size_t n, Scan scan) {
+    ScanPool& pool = ScanPool::shared();
+    size_t chunks = std::min(pool.threads() * 4, n);
+    size_t chunk_size = (n + chunks - 1) / chunks;
+    chunks = (n + chunk_size - 1) / chunk_size;
+    std::function<void(size_t)> job = [&](size_t c) {
+        size_t first = c * chunk_size;
+        scan(c, first, std::min(chunk_size, n - first));
+    };
+    pool.run(chunks, job);
+    return chunks;
+}
+
+// find_all_kernel, split across the ScanPool for large n. Each chunk collects its own
+// indices and the lists are concatenated in chunk order, so out stays sorted.
+template<typename T>
+void find_all_parallel(const T* data, size_t n, const T& val, std::vector<size_t>& out) {
+    if (n < parallel_scan_threshold() || ScanPool::shared().threads() == 1) {
+        find_all_kernel(data, n, val, out);
+        return;
+    }
+    std::vector<std::vector<size_t>> partial(ScanPool::shared().threads() * 4);
+    size_t chunks = parallel_chunks(n, [&](size_t c, size_t first, size_t count) {
+        find_all_kernel(data + first, count, val, partial[c], first);
+    });
+
+    size_t total = out.size();
+    for (size_t c = 0 ; c < chunks ; c++) { total += partial[c].size(); }
+    out.reserve(total);
+    for (size_t c = 0 ; c < chunks ; c++) {
+        out.insert(out.end(), partial[c].begin(), partial[c].end());
+    }
+}
+
+// count_kernel, split across the ScanPool for large n
+template<typename T>
+size_t count_parallel(const T* data, size_t n, const T& val) {
+    if (n < parallel_scan_threshold() || ScanPool::shared().threads() == 1) {
+        return count_kernel(data, n, val);
+    }
+    std::vector<size_t> partial(ScanPool::shared().threads() * 4, 0);
+    size_t chunks = parallel_chunks(n, [&](size_t c, size_t first, size_t count) {
+        partial[c] = count_kernel(data + first, count, val);
+    });
+    size_t total = 0;
+    for (size_t c = 0 ; c < chunks ; c++) { total += partial[c]; }
+    return total;
+}
+
+
+// Storage for the elements a Vec keeps inside the object itself (see SmallVec).
+// Raw bytes rather than T[N], so only the live elements are ever constructed.
+template<typename T, size_t N>
+struct InlineStorage {
+    alignas(T) unsigned char m_inline[N * sizeof(T)];
+
+    T* inline_data() { return reinterpret_cast<T*>(m_inline); }
+    const T* inline_data() const { return reinterpret_cast<const T*>(m_inline); }
+};
+
+// A Vec without inline storage takes up no extra space (empty base optimisation).
+template<typename T>
+struct InlineStorage<T, 0> {
+    T* inline_data() { return nullptr; }
+    const T* inline_data() const { return nullptr; }
+};
+
+
+// InlineCapacity > 0 gives the small-buffer mode: up to InlineCapacity elements are kept
+// inside the object and the heap is only used once the vector grows past that.
+// Heap buffers come from the global heap, or from a std::pmr::memory_resource (e.g. a
+// per-request arena) if one is given at construction. The resource follows std::pmr rules:
+// it moves with the buffer on move construction, is kept on assignment, and copies
+// use the global heap unless a resource is passed to the copy constructor.
+template<typename T, size_t InlineCapacity = 0>
+class Vec : private InlineStorage<T, InlineCapacity> {
 private:
     size_t m_size;
     size_t m_capacity;
     T* m_data;
+    std::pmr::memory_resource* m_resource; // nullptr means the global heap
     static const size_t MIN_CAPACITY = 1;
     static const size_t GROWTH_FACTOR = 2;
     static const size_t SHRINK_FACTOR = 2;
     static const size_t CONTRACTION_THRESHOLD = 4;
 
+    // Heap buffers of at least this many bytes are mapped straight from the kernel when the
+    // elements are trivially copyable, so that growing or shrinking them is a page remap (mremap).
+    static const size_t LARGE_BUFFER_BYTES = size_t(1) << 20;
+#ifdef __linux__
+    static const bool CAN_REMAP = std::is_trivially_copyable<T>::value;
+#else
+    static const bool CAN_REMAP = false;
+#endif
+
 public:
-    Vec() : m_size(0), m_capacity(MIN_CAPACITY) {
-        m_data = new T[m_capacity];
+    Vec() : m_resource(nullptr) {
+        init_empty();
     }
 
-    Vec(size_t initial_size, const T& initial_val)
-        : m_size(initial_size), m_capacity(bit_ceil(initial_size)) {
-        m_data = new T[m_capacity];
-        for (size_t i = 0 ; i < initial_size ; i++) {
-            m_data[i] = initial_val;
-        }
+    // Empty vector whose heap buffers are allocated from resource
+    explicit Vec(std::pmr::memory_resource* resource) : m_resource(resource) {
+        init_empty();
+    }
+
+    Vec(size_t initial_size, const T& initial_val, std::pmr::memory_resource* resource = nullptr)
+        : m_size(initial_size), 
+          m_capacity(InlineCapacity > 0 && initial_size <= InlineCapacity ? InlineCapacity : bit_ceil(initial_size)),
+          m_resource(resource) {
+        m_data = acquire(m_capacity);
+        std::uninitialized_fill_n(m_data, initial_size, initial_val);
     }
 
     ~Vec() {
-        delete[] m_data;
+        std::destroy_n(m_data, m_size);
+        release(m_data, m_capacity);
     }
 
     // Copy constructor
-    Vec(const Vec& other) : m_size(other.m_size), m_capacity(other.m_capacity) {
-        m_data = new T[m_capacity];
-        std::copy(other.m_data, other.m_data + m_size, m_data);
+    // The copy lives on the global heap: it may well outlive other's memory resource.
+    Vec(const Vec& other) : Vec(other, nullptr) {}
+
+    // Copy constructor with the memory resource to allocate the copy from
+    Vec(const Vec& other, std::pmr::memory_resource* resource) 
+        : m_size(other.m_size), m_capacity(other.is_inline() ? InlineCapacity : other.m_capacity),
+          m_resource(resource) {
+        m_data = acquire(m_capacity);
+        std::uninitialized_copy_n(other.m_data, m_size, m_data);
     }
 
     // Copy assignment operator
@@ -64,44 +552,70 @@ public:
             return *this;
         }
 
-        Vec tmp(other); // Create a copy using the copy constructor.
-        std::swap(m_size, tmp.m_size);
-        std::swap(m_capacity, tmp.m_capacity);
-        std::swap(m_data, tmp.m_data);
+        Vec tmp(other, m_resource); // Create a copy using the copy constructor, from our own resource.
+        *this = std::move(tmp); // A plain pointer swap would not work for inline storage.
         return *this;
     }
 
     // Move constructor
-    Vec(Vec&& other) noexcept : m_size(other.m_size), m_capacity(other.m_capacity), m_data(other.m_data) {
-        other.m_size = 0;
-        other.m_capacity = MIN_CAPACITY; 
-        other.m_data = new T[MIN_CAPACITY];
+    // Inline elements cannot be stolen, so they are relocated instead.
+    Vec(Vec&& other) noexcept 
+        : m_size(other.m_size), m_capacity(other.m_capacity), m_resource(other.m_resource) {
+        if (other.is_inline()) {
+            m_data = this->inline_data();
+            relocate_elements(other.m_data, m_size, m_data);
+            other.m_size = 0;
+        }
+        else {
+            m_data = other.m_data;
+            other.init_empty();
+        }
     }
 
     // Move assignment operator
-    Vec& operator=(Vec&& other) noexcept {
+    // This vector keeps its memory resource, so a heap buffer from a different resource cannot
+    // be stolen: the elements are relocated into a buffer from our resource instead.
+    Vec& operator=(Vec&& other) {
         if (this != &other) {
-            delete[] m_data;
+            std::destroy_n(m_data, m_size);
+            release(m_data, m_capacity);
 
             m_size = other.m_size; 
             m_capacity = other.m_capacity; 
-            m_data = other.m_data;
 
-            other.m_size = 0; 
-            other.m_capacity = 0;
-            other.m_data = nullptr;
+            if (other.is_inline()) {
+                m_data = this->inline_data();
+                relocate_elements(other.m_data, m_size, m_data);
+                other.m_size = 0;
+            }
+            else if (same_resource(m_resource, other.m_resource)) {
+                m_data = other.m_data;
+                other.init_empty();
+            }
+            else {
+                m_data = nullptr; // keeps this vector valid if acquire throws
+                m_size = 0;
+                m_capacity = 0;
+                T* data = acquire(other.m_capacity);
+                relocate_elements(other.m_data, other.m_size, data);
+                m_data = data;
+                m_size = other.m_size;
+                m_capacity = other.m_capacity;
+                other.release(other.m_data, other.m_capacity);
+                other.init_empty();
+            }
         }
         return *this;
     }
 
+    // @returns Returns the memory resource heap buffers are allocated from (nullptr for the global heap)
+    std::pmr::memory_resource* resource() const { return m_resource; }
+
     // Check if the vector contains a value
     // @returns Returns true if an element with value val exists in the vector
     // @returns Returns false otherwise
     bool contains(const T& val) const {
-        for (size_t i = 0 ; i < m_size ; i++) {
-            if (m_data[i] == val) { return true; }
-        }
-        return false;
+        return find_first_kernel(m_data, m_size, val) != m_size;
     }
 
     // @return Returns the value at index i. 
@@ -117,47 +631,111 @@ public:
     // @returns Returns the index of the first occurrence of val
     // @returns Returns -1 if val does not exist in the vector
     int find_first(const T& val) const {
-        for (size_t i = 0 ; i < m_size ; i++) {
-            if (m_data[i] == val) { return i; }
-        }
-        return -1;
+        size_t idx = find_first_kernel(m_data, m_size, val);
+        return idx == m_size ? -1 : static_cast<int>(idx);
     }
 
     // Finds all indices of a value in the vector
     // @returns Returns an std::vector with the indices of the val
     // @returns Returns an empty array if the val does not occur in the vector
+    // (large vectors are scanned in parallel, see parallel_scan_threshold)
     std::vector<size_t> find_all(const T& val) const {
         std::vector<size_t> idxs = {};
-        for (size_t i = 0 ; i < m_size ; i++) {
-            if (m_data[i] == val) { idxs.push_back(i); } 
-        }
+        find_all_parallel(m_data, m_size, val, idxs);
         return idxs;
     }
 
+    // Counts the occurrences of a value in the vector
+    // (large vectors are scanned in parallel, see parallel_scan_threshold)
+    // @returns Returns the number of elements equal to val
+    size_t count(const T& val) const {
+        return count_parallel(m_data, m_size, val);
+    }
+
+    // @returns Returns the number of elements in the vector
+    size_t size() const { return m_size; }
+
+    // @returns Returns the number of elements the vector can hold before it reallocates
+    size_t capacity() const { return m_capacity; }
+
     // Appends an element to the back of the array
     void push_back(const T& val) {
+        emplace_back(val);
+    }
+
+    void push_back(T&& val) {
+        emplace_back(std::move(val));
+    }
+
+    // Constructs an element in place at the back of the array, from the given constructor arguments
+    // @returns Returns a reference to the new element
+    template<typename... Args>
+    T& emplace_back(Args&&... args) {
         if (m_size == m_capacity) {
-            m_capacity = m_capacity * GROWTH_FACTOR;
-            T* tmp = new T[m_capacity];
-            for (size_t i = 0; i < m_size ; i++) {
-                tmp[i] = m_data[i];
-            }
-            delete[] m_data;
-            m_data = tmp;
+            T tmp(std::forward<Args>(args)...); // args may refer to an element of this vector, which is about to move
+            reallocate(m_capacity > 0 ? m_capacity * GROWTH_FACTOR : MIN_CAPACITY);
+            new (m_data + m_size) T(std::move(tmp));
         }
+        else {
+            new (m_data + m_size) T(std::forward<Args>(args)...);
+        }
+        return m_data[m_size++];
+    }
+
+    // Makes room for at least new_capacity elements, without constructing any of them
+    void reserve(size_t new_capacity) {
+        if (new_capacity > m_capacity) {
+            reallocate(new_capacity);
+        }
+    }
 
-        m_data[m_size] = val;
-        m_size++;
+    // Changes the number of elements to new_size.
+    // New elements are value-initialised; surplus elements are destroyed (the capacity is kept).
+    void resize(size_t new_size) {
+        if (new_size <= m_size) {
+            std::destroy_n(m_data + new_size, m_size - new_size);
+        }
+        else {
+            reserve(new_size);
+            std::uninitialized_value_construct_n(m_data + m_size, new_size - m_size);
+        }
+        m_size = new_size;
+    }
+
+    // Changes the number of elements to new_size, filling any new elements with copies of val
+    void resize(size_t new_size, const T& val) {
+        if (new_size <= m_size) {
+            std::destroy_n(m_data + new_size, m_size - new_size);
+        }
+        else if (new_size > m_capacity) {
+            T copy(val); // val may be an element of this vector, which is about to move
+            reserve(new_size);
+            std::uninitialized_fill_n(m_data + m_size, new_size - m_size, copy);
+        }
+        else {
+            std::uninitialized_fill_n(m_data + m_size, new_size - m_size, val);
+        }
+        m_size = new_size;
+    }
+
+    // Releases any capacity beyond the current size
+    void shrink_to_fit() {
+        if (is_inline() || m_capacity == m_size) { return; }
+        if (m_size == 0 && InlineCapacity == 0) {
+            release(m_data, m_capacity);
+            init_empty();
+            return;
+        }
+        reallocate(m_size > InlineCapacity ? m_size : InlineCapacity);
     }
 
     // deletes the element at the given index
     // @throws out_of_range if provided idx is out of range
     void delete_at_index(size_t idx) {
         if (idx >= m_size) { throw std::out_of_range("Index out of range for deletion"); }
-        for (size_t ptr = idx ; ptr < m_size - 1 ; ptr++) {
-            m_data[ptr] = m_data[ptr+1];
-        }
+        std::move(m_data + idx + 1, m_data + m_size, m_data + idx);
         m_size--;
+        m_data[m_size].~T();
         shrink_if_necessary();
     }
 
@@ -165,31 +743,41 @@ public:
     // @returns Returns true if a deletion occurred
     // @returns false otherwise.
     bool delete_first_instance(const T& val) {
-        for (size_t idx = 0 ; idx < m_size ; idx++) {
-            if (m_data[idx] == val) {
-                delete_at_index(idx);
-                return true;
-            }
-        }
-        return false;
+        size_t idx = find_first_kernel(m_data, m_size, val);
+        if (idx == m_size) { return false; }
+        delete_at_index(idx);
+        return true;
     }
 
     // deletes all instances of the value val, if it exists
     // @returns Returns the number of deletions which occurred
     int delete_all_instances(const T& val) {
-        int deletionCounter = 0;
-        for (size_t idx = 0 ; idx < m_size; ) {
-            if (m_data[idx] == val) {
-                delete_at_index(idx);
-                deletionCounter++;
-            }
-            else { idx++; } // increment only if no deletion occurred
-        }
-        return deletionCounter;
+        // everything before the first match stays where it is
+        size_t first = find_first_kernel(m_data, m_size, val);
+        if (first == m_size) { return 0; }
+        return static_cast<int>(compact_from(first, [&val](const T& elem) { return elem == val; }));
+    }
+
+    // deletes every element for which pred(element) returns true, keeping the order of the rest
+    // @returns Returns the number of deletions which occurred
+    template<typename Predicate>
+    size_t erase_if(Predicate pred) {
+        return compact_from(0, pred);
+    }
+
+    // deletes the elements with indices in [first, last)
+    // @throws out_of_range if the range is not within the vector
+    void erase(size_t first, size_t last) {
+        if (first > last || last > m_size) { throw std::out_of_range("Range out of range for deletion"); }
+        if (first == last) { return; }
+        std::move(m_data + last, m_data + m_size, m_data + first);
+        std::destroy_n(m_data + m_size - (last - first), last - first);
+        m_size -= last - first;
+        shrink_if_necessary();
     }
 
     // @overload Overload for the stream insertion operator, to print the contents of vec object
-    friend std::ostream& operator<<(std::ostream& os, const Vec<T>& vec) {
+    friend std::ostream& operator<<(std::ostream& os, const Vec& vec) {
         os << "******** VEC ********\n";
         os << "m_size = " << vec.m_size << " | m_capacity = " << vec.m_capacity << std::endl;
         if (vec.m_size <= 0) {
@@ -210,26 +798,290 @@ public:
     }
 
 private:
+    // @returns Returns true if the elements currently live in the inline storage
+    bool is_inline() const {
+        return InlineCapacity > 0 && m_data == this->inline_data();
+    }
+
+    // Points the vector at an empty buffer: the inline storage if there is one,
+    // otherwise no buffer at all (the first insertion allocates).
+    void init_empty() {
+        m_size = 0;
+        m_capacity = InlineCapacity;
+        m_data = this->inline_data(); // nullptr if there is no inline storage
+    }
+
+    // @returns Returns true if a heap buffer of this capacity is mapped from the kernel
+    // (only buffers from the global heap are; a memory resource manages its own memory)
+    bool is_mapped(size_t capacity) const {
+        return CAN_REMAP && m_resource == nullptr && capacity > InlineCapacity 
+            && capacity * sizeof(T) >= LARGE_BUFFER_BYTES;
+    }
+
+    // @returns Returns true if memory from resource a can be freed through resource b
+    static bool same_resource(std::pmr::memory_resource* a, std::pmr::memory_resource* b) {
+        return a == b || (a != nullptr && b != nullptr && a->is_equal(*b));
+    }
+
+    // Returns uninitialised storage with room for capacity elements.
+    // Capacities which fit inline use the inline storage, so this must only be called
+    // while the inline storage is not holding any elements.
+    // @throws std::bad_alloc if the memory cannot be allocated
+    T* acquire(size_t capacity) {
+        if (InlineCapacity > 0 && capacity <= InlineCapacity) { return this->inline_data(); }
+#ifdef __linux__
+        if (is_mapped(capacity)) {
+            void* p = mmap(nullptr, capacity * sizeof(T), PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (p == MAP_FAILED) { throw std::bad_alloc(); }
+            return static_cast<T*>(p);
+        }
+#endif
+        if (m_resource != nullptr) {
+            return static_cast<T*>(m_resource->allocate(capacity * sizeof(T), alignof(T)));
+        }
+        if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+            return static_cast<T*>(::operator new(capacity * sizeof(T), std::align_val_t(alignof(T))));
+        }
+        return static_cast<T*>(::operator new(capacity * sizeof(T)));
+    }
+
+    // Frees a buffer obtained from acquire(); the inline storage is never freed.
+    // The elements must already have been destroyed or relocated.
+    void release(T* data, size_t capacity) {
+        if (data == nullptr || (InlineCapacity > 0 && data == this->inline_data())) { return; }
+#ifdef __linux__
+        if (is_mapped(capacity)) {
+            munmap(data, capacity * sizeof(T));
+            return;
+        }
+#endif
+        if (m_resource != nullptr) {
+            m_resource->deallocate(data, capacity * sizeof(T), alignof(T));
+            return;
+        }
+        if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+            ::operator delete(data, std::align_val_t(alignof(T)));
+            return;
+        }
+        ::operator delete(data);
+    }
+
+    // Moves n elements from src into the uninitialised storage dst, and destroys the originals.
+    // Trivially copyable elements are copied with one memcpy. Other elements are moved if their
+    // move constructor cannot throw and copied otherwise, so a throwing move cannot lose elements.
+    static void relocate_elements(T* src, size_t n, T* dst) {
+        if constexpr (std::is_trivially_copyable<T>::value) {
+            if (n > 0) { std::memcpy(dst, src, n * sizeof(T)); }
+        }
+        else {
+            for (size_t i = 0 ; i < n ; i++) {
+                new (dst + i) T(std::move_if_noexcept(src[i]));
+            }
+            std::destroy_n(src, n);
+        }
+    }
+
+    // Moves the elements into a buffer of new_capacity (the inline storage if they fit there).
+    // Large mapped buffers are resized by the kernel, which moves pages instead of bytes;
+    // otherwise each element is relocated once into fresh uninitialised storage.
+    void reallocate(size_t new_capacity) {
+#ifdef __linux__
+        if (!is_inline() && is_mapped(m_capacity) && is_mapped(new_capacity)) {
+            void* p = mremap(m_data, m_capacity * sizeof(T), new_capacity * sizeof(T), MREMAP_MAYMOVE);
+            if (p == MAP_FAILED) { throw std::bad_alloc(); }
+            m_data = static_cast<T*>(p);
+            m_capacity = new_capacity;
+            return;
+        }
+#endif
+        T* new_data = acquire(new_capacity);
+        relocate_elements(m_data, m_size, new_data);
+        release(m_data, m_capacity);
+        m_data = new_data;
+        m_capacity = new_capacity;
+    }
+
+    // Stable single-pass compaction: starting at index start, every element matching pred is
+    // dropped and the survivors are moved down over the gaps. Shrinks at most once, at the end.
+    // @returns Returns the number of elements removed
+    template<typename Predicate>
+    size_t compact_from(size_t start, Predicate&& pred) {
+        size_t write = start;
+        for (size_t read = start ; read < m_size ; read++) {
+            if (pred(m_data[read])) { continue; }
+            if (write != read) { m_data[write] = std::move(m_data[read]); }
+            write++;
+        }
+        size_t removed = m_size - write;
+        std::destroy_n(m_data + write, removed);
+        m_size = write;
+        shrink_if_necessary();
+        return removed;
+    }
+
     // Checks whether a shrink of the allocated memory is necessary (see contraction threshold).
-    // If a shrink is necessary, it is performed.
+    // If a shrink is necessary, it is performed in one reallocation, even if the capacity
+    // has to be halved several times (e.g. after a bulk deletion).
+    // Once the elements fit inline again they are moved back into the inline storage.
     void shrink_if_necessary() {
+        if (is_inline()) { return; }
         if (m_capacity > MIN_CAPACITY && m_size <= m_capacity / CONTRACTION_THRESHOLD) {
-            size_t new_capacity = m_capacity / SHRINK_FACTOR;
-
-            T* new_data = new T[new_capacity];
-            for (size_t i = 0 ; i < m_size ; i++) {
-                new_data[i] = std::move(m_data[i]);
+            size_t new_capacity = m_capacity;
+            while (new_capacity > MIN_CAPACITY && m_size <= new_capacity / CONTRACTION_THRESHOLD) {
+                new_capacity /= SHRINK_FACTOR;
             }
-    
-            delete[] m_data;
-            m_data = new_data;
-            m_capacity = new_capacity;
+            if (InlineCapacity > 0 && (m_size <= InlineCapacity || new_capacity <= InlineCapacity)) {
+                new_capacity = InlineCapacity;
+            }
+            reallocate(new_capacity);
         }
     }
 
 };
 
+// Vec which keeps up to N elements inline and only allocates once it grows past N.
+template<typename T, size_t N = 16>
+using SmallVec = Vec<T, N>;
+
+
+
+// Counts heap allocations, for the benchmark in main().
+static std::atomic<size_t> g_allocations(0);
+
+void* operator new(size_t bytes) {
+    g_allocations++;
+    if (void* p = std::malloc(bytes)) { return p; }
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t bytes) {
+    return operator new(bytes);
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+
+// Builds and destroys many short vectors (the common case) and reports
+// the heap allocations and time per vector.
+template<typename VecType>
+void benchmarkShortVecs(const std::string& name, size_t elements_per_vec) {
+    const size_t ITERATIONS = 1000000;
+    size_t sink = 0;
+    size_t allocations_before = g_allocations;
+    auto start = std::chrono::steady_clock::now();
+
+    for (size_t i = 0 ; i < ITERATIONS ; i++) {
+        VecType v;
+        for (size_t j = 0 ; j < elements_per_vec ; j++) {
+            v.push_back(static_cast<int>(i + j));
+        }
+        sink += v.at(elements_per_vec - 1);
+    }
+
+    auto end = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(end - start).count();
+    std::cout << name << " (" << elements_per_vec << " elements): "
+              << static_cast<double>(g_allocations - allocations_before) / ITERATIONS << " allocs/vec, "
+              << ns / ITERATIONS << " ns/vec (checksum " << sink << ")" << std::endl;
+}
+
+// Simulates requests which each build a few short-lived vectors, taking their buffers either from
+// the global heap or from a per-request monotonic arena that is released in one go at the end.
+void benchmarkRequestArena(bool use_arena) {
+    const size_t REQUESTS = 100000;
+    const int VECS_PER_REQUEST = 16;
+    const int ELEMENTS_PER_VEC = 64;
+    alignas(std::max_align_t) static unsigned char arena_buffer[64 * 1024];
+
+    size_t sink = 0;
+    size_t allocations_before = g_allocations;
+    auto start = std::chrono::steady_clock::now();
+
+    for (size_t r = 0 ; r < REQUESTS ; r++) {
+        std::pmr::monotonic_buffer_resource arena(arena_buffer, sizeof(arena_buffer));
+        std::pmr::memory_resource* resource = use_arena ? &arena : nullptr;
+
+        for (int v = 0 ; v < VECS_PER_REQUEST ; v++) {
+            Vec<int> vec(resource);
+            for (int i = 0 ; i < ELEMENTS_PER_VEC ; i++) {
+                vec.push_back(static_cast<int>(r) + i);
+            }
+            sink += vec.find_first(static_cast<int>(r) + v);
+        }
+    } // arena memory is released here, all at once
+
+    auto end = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(end - start).count();
+    std::cout << (use_arena ? "request arena" : "global heap") << ": "
+              << static_cast<double>(g_allocations - allocations_before) / REQUESTS << " allocs/request, "
+              << ns / REQUESTS << " ns/request (checksum " << sink << ")" << std::endl;
+}
+
+// Times the scalar search loops against the runtime-selected SIMD kernels on n elements of type T.
+// The searched value sits in the last slot (worst case for find_first) and at every 100th slot.
+template<typename T>
+void benchmarkSearch(const std::string& name, size_t n) {
+    const int REPEATS = 20;
+    std::vector<T> data(n, T(1));
+    for (size_t i = 99 ; i < n ; i += 100) { data[i] = T(7); }
+    data[n - 1] = T(9);
+
+    auto time_ns = [&](auto&& fn) {
+        auto start = std::chrono::steady_clock::now();
+        for (int r = 0 ; r < REPEATS ; r++) { fn(); }
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(end - start).count() / REPEATS;
+    };
+
+    size_t first_scalar = 0, first_simd = 0;
+    std::vector<size_t> all_scalar, all_simd;
+    double t_first_scalar = time_ns([&] { first_scalar = find_first_scalar(data.data(), n, T(9)); });
+    double t_first_simd = time_ns([&] { first_simd = find_first_kernel(data.data(), n, T(9)); });
+    double t_all_scalar = time_ns([&] { all_scalar.clear(); find_all_scalar(data.data(), n, T(7), all_scalar); });
+    double t_all_simd = time_ns([&] { all_simd.clear(); find_all_kernel(data.data(), n, T(7), all_simd); });
+
+    if (first_scalar != first_simd || all_scalar != all_simd) {
+        throw std::logic_error("SIMD search kernels disagree with the scalar loops");
+    }
+    std::cout << name << " x " << n << ": find_first " << t_first_scalar / n << " -> " << t_first_simd / n
+              << " ns/elem, find_all " << t_all_scalar / n << " -> " << t_all_simd / n << " ns/elem" << std::endl;
+}
+
+// Times find_all and count over n ints on one thread against the ScanPool
+void benchmarkParallelScan(size_t n) {
+    Vec<int> v;
+    v.reserve(n);
+    for (size_t i = 0 ; i < n ; i++) {
+        v.push_back(i % 1000 == 0 ? 7 : 1);
+    }
 
+    auto time_ms = [](auto&& fn) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    size_t saved_threshold = parallel_scan_threshold();
+    std::vector<size_t> serial_idxs, parallel_idxs;
+    size_t serial_count = 0, parallel_count = 0;
+
+    parallel_scan_threshold() = SIZE_MAX; // force the single-threaded path
+    double t_find_serial = time_ms([&] { serial_idxs = v.find_all(7); });
+    double t_count_serial = time_ms([&] { serial_count = v.count(7); });
+    parallel_scan_threshold() = saved_threshold;
+    double t_find_parallel = time_ms([&] { parallel_idxs = v.find_all(7); });
+    double t_count_parallel = time_ms([&] { parallel_count = v.count(7); });
+
+    if (serial_idxs != parallel_idxs || serial_count != parallel_count) {
+        throw std::logic_error("parallel scan disagrees with the single-threaded scan");
+    }
+    double gb = n * sizeof(int) / 1e9;
+    std::cout << "scan of " << n << " ints on " << ScanPool::shared().threads() << " thread(s): "
+              << "find_all " << gb / (t_find_serial / 1e3) << " -> " << gb / (t_find_parallel / 1e3) << " GB/s, "
+              << "count " << gb / (t_count_serial / 1e3) << " -> " << gb / (t_count_parallel / 1e3) << " GB/s" << std::endl;
+}
 
 
 int main() {
@@ -261,4 +1113,51 @@ int main() {
     }
 
     std::cout << vCopy;
+
+    SmallVec<int, 4> sv;
+    for (int i = 0 ; i < 6 ; i++) {
+        sv.push_back(i);
+    }
+    std::cout << sv;
+    for (int i = 0 ; i < 4 ; i++) {
+        sv.delete_at_index(0); // shrinks back into the inline storage
+    }
+    std::cout << sv;
+
+    Vec<std::string> words;
+    words.reserve(4); // one allocation, no strings constructed yet
+    words.emplace_back("emplaced");
+    words.emplace_back(3, 'x');
+    words.push_back(std::string("moved"));
+    words.resize(5, "filled");
+    words.shrink_to_fit();
+    std::cout << words;
+
+    Vec<int> purge;
+    for (int i = 0 ; i < 64 ; i++) {
+        purge.push_back(i % 8);
+    }
+    purge.delete_all_instances(3);
+    purge.erase_if([](int x) { return x % 2 == 0; }); // one pass, one shrink
+    purge.erase(4, purge.size());
+    std::cout << purge;
+
+    for (size_t n : {4, 12, 32}) {
+        benchmarkShortVecs<Vec<int>>("Vec<int>", n);
+        benchmarkShortVecs<SmallVec<int, 16>>("SmallVec<int, 16>", n);
+    }
+
+    benchmarkRequestArena(false);
+    benchmarkRequestArena(true);
+
+    const char* levels[] = {"scalar", "SSE4.1", "AVX2"};
+    std::cout << "search kernels: " << levels[static_cast<int>(simd_level())] << " (scalar -> selected)" << std::endl;
+    benchmarkSearch<int8_t>("int8_t", 8000000);
+    benchmarkSearch<int16_t>("int16_t", 8000000);
+    benchmarkSearch<int>("int", 8000000);
+    benchmarkSearch<int64_t>("int64_t", 8000000);
+    benchmarkSearch<float>("float", 8000000);
+    benchmarkSearch<double>("double", 8000000);
+
+    benchmarkParallelScan(64000000);
 }
\ No newline at end of file
@@ -0,0 +1,239 @@
+/**
+ * A persistent dynamic array of trivially copyable elements, backed by a memory-mapped file.
+ * The elements live directly in the file, so reopening an existing array only maps it
+ * (no parsing or re-ingesting), and the kernel pages data in on demand.
+ * Linux only (mremap).
+ */
+
+#include <stdexcept>
+#include <iostream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <chrono>
+#include <cerrno>
+#include <cstring>
+#include <cstdint>
+#include <cstddef>
+#include <cstdio>
+#include <type_traits>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+
+template<typename T>
+class MappedVec {
+    static_assert(std::is_trivially_copyable<T>::value, "MappedVec stores raw bytes, T must be trivially copyable");
+
+private:
+    // Stored at the start of the file. The element count lives in the mapping itself,
+    // so push_back persists it without a system call.
+    struct Header {
+        uint64_t magic;
+        uint64_t element_size;
+        uint64_t size;
+    };
+
+    static const uint64_t MAGIC = 0x3156434556504d41; // "AMPVECV1"
+    static const size_t DATA_OFFSET = 64; // keeps the elements cache-line aligned
+    static const size_t MIN_CAPACITY = 1024;
+    static const size_t GROWTH_FACTOR = 2;
+
+    int m_fd;
+    size_t m_capacity;
+    size_t m_mapped_bytes;
+    unsigned char* m_map;
+
+    Header* header() const { return reinterpret_cast<Header*>(m_map); }
+    T* data() const { return reinterpret_cast<T*>(m_map + DATA_OFFSET); }
+
+    static size_t bytes_for(size_t capacity) { return DATA_OFFSET + capacity * sizeof(T); }
+
+    // @throws runtime_error describing the failed system call
+    [[noreturn]] static void fail(const std::string& what) {
+        throw std::runtime_error(what + ": " + std::strerror(errno));
+    }
+
+public:
+    // Opens the array stored in the file at path, creating an empty one if the file does not exist.
+    // Only the element size is recorded, so a file of another type of the same size opens without error.
+    // @throws runtime_error if the file cannot be opened or mapped, or holds elements of a different size
+    explicit MappedVec(const std::string& path) : m_fd(-1), m_capacity(0), m_mapped_bytes(0), m_map(nullptr) {
+        m_fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (m_fd < 0) { fail("open " + path); }
+
+        struct stat st;
+        if (::fstat(m_fd, &st) != 0) { ::close(m_fd); fail("fstat " + path); }
+
+        bool is_new = st.st_size == 0;
+        size_t file_bytes = is_new ? bytes_for(MIN_CAPACITY) : static_cast<size_t>(st.st_size);
+        if (file_bytes < DATA_OFFSET) {
+            ::close(m_fd);
+            throw std::runtime_error("MappedVec file " + path + " is truncated");
+        }
+        if (is_new && ::ftruncate(m_fd, file_bytes) != 0) { ::close(m_fd); fail("ftruncate " + path); }
+
+        void* map = ::mmap(nullptr, file_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+        if (map == MAP_FAILED) { ::close(m_fd); fail("mmap " + path); }
+        m_map = static_cast<unsigned char*>(map);
+        m_mapped_bytes = file_bytes;
+        m_capacity = (file_bytes - DATA_OFFSET) / sizeof(T);
+
+        if (is_new) {
+            *header() = Header{MAGIC, sizeof(T), 0};
+        }
+        else if (header()->magic != MAGIC || header()->element_size != sizeof(T) || header()->size > m_capacity) {
+            ::munmap(m_map, m_mapped_bytes);
+            ::close(m_fd);
+            throw std::runtime_error("MappedVec file " + path + " has a bad header or a different element size");
+        }
+    }
+
+    // Unmaps the file; the kernel writes any dirty pages back (call flush() to wait for that).
+    ~MappedVec() {
+        if (m_map != nullptr) { ::munmap(m_map, m_mapped_bytes); }
+        if (m_fd >= 0) { ::close(m_fd); }
+    }
+
+    // A MappedVec owns its file mapping, so it can be moved but not copied.
+    MappedVec(const MappedVec&) = delete;
+    MappedVec& operator=(const MappedVec&) = delete;
+
+    MappedVec(MappedVec&& other) noexcept
+        : m_fd(other.m_fd), m_capacity(other.m_capacity), m_mapped_bytes(other.m_mapped_bytes), m_map(other.m_map) {
+        other.m_fd = -1;
+        other.m_map = nullptr;
+        other.m_capacity = 0;
+        other.m_mapped_bytes = 0;
+    }
+
+    MappedVec& operator=(MappedVec&& other) noexcept {
+        if (this != &other) {
+            std::swap(m_fd, other.m_fd);
+            std::swap(m_capacity, other.m_capacity);
+            std::swap(m_mapped_bytes, other.m_mapped_bytes);
+            std::swap(m_map, other.m_map);
+        }
+        return *this;
+    }
+
+    // @returns Returns the number of elements in the array
+    size_t size() const { return m_map == nullptr ? 0 : header()->size; }
+
+    // @returns Returns the number of elements the file can hold before it has to grow
+    size_t capacity() const { return m_capacity; }
+
+    // Check if the array contains a value
+    // @returns Returns true if an element with value val exists in the array
+    // @returns Returns false otherwise
+    bool contains(const T& val) const {
+        return std::find(data(), data() + size(), val) != data() + size();
+    }
+
+    // @return Returns the value at index i.
+    // @throws Throws std::out_of_range if out of bounds.
+    T at(size_t i) const {
+        if (i >= size()) {
+            throw std::out_of_range("Attempting to access elements which are out of range.");
+        }
+        return data()[i];
+    }
+
+    // Finds the index of a value in the array
+    // @returns Returns the index of the first occurrence of val
+    // @returns Returns -1 if val does not exist in the array
+    // (a ptrdiff_t rather than an int, since a file-backed array can hold more than 2^31 elements)
+    ptrdiff_t find_first(const T& val) const {
+        const T* it = std::find(data(), data() + size(), val);
+        return it == data() + size() ? -1 : it - data();
+    }
+
+    // Finds all indices of a value in the array
+    // @returns Returns an std::vector with the indices of the val
+    // @returns Returns an empty array if the val does not occur in the array
+    std::vector<size_t> find_all(const T& val) const {
+        std::vector<size_t> idxs = {};
+        for (size_t i = 0 ; i < size() ; i++) {
+            if (data()[i] == val) { idxs.push_back(i); }
+        }
+        return idxs;
+    }
+
+    // Appends an element to the back of the array
+    // @throws runtime_error if the file cannot be grown
+    void push_back(const T& val) {
+        if (size() == m_capacity) {
+            T copy = val; // val may live in the mapping, which is about to move
+            reserve(std::max(m_capacity * GROWTH_FACTOR, size_t(MIN_CAPACITY))); // an opened file may have no room at all
+            data()[size()] = copy;
+        }
+        else {
+            data()[size()] = val;
+        }
+        header()->size++;
+    }
+
+    // Grows the file (and the mapping) so it can hold at least new_capacity elements.
+    // The existing pages are remapped, never copied.
+    // @throws runtime_error if the file cannot be grown
+    void reserve(size_t new_capacity) {
+        if (new_capacity <= m_capacity) { return; }
+        size_t new_bytes = bytes_for(new_capacity);
+        if (::ftruncate(m_fd, new_bytes) != 0) { fail("ftruncate"); }
+        void* map = ::mremap(m_map, m_mapped_bytes, new_bytes, MREMAP_MAYMOVE);
+        if (map == MAP_FAILED) { fail("mremap"); }
+        m_map = static_cast<unsigned char*>(map);
+        m_mapped_bytes = new_bytes;
+        m_capacity = new_capacity;
+    }
+
+    // Removes all elements (the file keeps its capacity)
+    void clear() {
+        header()->size = 0;
+    }
+
+    // Blocks until all changes have been written to the file
+    // @throws runtime_error if the write-back fails
+    void flush() {
+        if (::msync(m_map, m_mapped_bytes, MS_SYNC) != 0) { fail("msync"); }
+    }
+};
+
+
+
+int main() {
+    std::string path = "/tmp/mapped_vec_demo.bin";
+    std::remove(path.c_str());
+
+    const size_t N = 10000000;
+    auto start = std::chrono::steady_clock::now();
+    {
+        MappedVec<uint64_t> ids(path);
+        for (size_t i = 0 ; i < N ; i++) {
+            ids.push_back(i * 3);
+        }
+        std::cout << "ingested " << ids.size() << " ids, capacity " << ids.capacity() << std::endl;
+    }
+    auto ingested = std::chrono::steady_clock::now();
+
+    MappedVec<uint64_t> reopened(path);
+    auto opened = std::chrono::steady_clock::now();
+
+    std::cout << "ingest: " << std::chrono::duration<double, std::milli>(ingested - start).count() << " ms, "
+              << "reopen: " << std::chrono::duration<double, std::micro>(opened - ingested).count() << " us" << std::endl;
+    std::cout << "size after reopen = " << reopened.size()
+              << " | at(12345) = " << reopened.at(12345)
+              << " | contains(30) = " << reopened.contains(30)
+              << " | find_first(31) = " << reopened.find_first(31) << std::endl;
+
+    try {
+        MappedVec<uint32_t> wrong_size(path); // the file holds 8-byte elements
+    }
+    catch (const std::runtime_error& e) {
+        std::cout << "expected error: " << e.what() << std::endl;
+    }
+
+    std::remove(path.c_str());
+}
@@ -0,0 +1,270 @@
+/**
+ * A segmented dynamic array: elements are stored in a directory of blocks whose sizes
+ * double (FIRST_BLOCK, 2 * FIRST_BLOCK, 4 * FIRST_BLOCK, ...).
+ * Growing allocates one new block and never moves existing elements, so pointers and
+ * references to elements stay valid, and no append ever has to copy the whole array.
+ * Indexing is O(1): the block number is read off the highest set bit of the index.
+ */
+
+#include <stdexcept>
+#include <iostream>
+#include <vector>
+#include <string>
+#include <utility>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <new>
+
+
+template<typename T>
+class SegmentedVec {
+private:
+    static const size_t FIRST_BLOCK_LOG2 = 4;
+    static const size_t FIRST_BLOCK = size_t(1) << FIRST_BLOCK_LOG2;
+    // block k holds FIRST_BLOCK << k elements, so this many blocks cover the whole address space
+    static const size_t MAX_BLOCKS = 64 - FIRST_BLOCK_LOG2;
+
+    size_t m_size;
+    size_t m_num_blocks;
+    T* m_blocks[MAX_BLOCKS]; // the block directory; it never moves either
+
+    static size_t block_capacity(size_t block) { return FIRST_BLOCK << block; }
+
+    // Maps an index to its block and the offset within that block.
+    // Block k starts at index FIRST_BLOCK * (2^k - 1), so idx + FIRST_BLOCK has its highest bit
+    // at position k + FIRST_BLOCK_LOG2, and the bits below it are the offset.
+    static void locate(size_t idx, size_t& block, size_t& offset) {
+        size_t shifted = idx + FIRST_BLOCK;
+        size_t high_bit = 63 - __builtin_clzll(shifted);
+        block = high_bit - FIRST_BLOCK_LOG2;
+        offset = shifted - (size_t(1) << high_bit);
+    }
+
+    T* slot(size_t idx) const {
+        size_t block, offset;
+        locate(idx, block, offset);
+        return m_blocks[block] + offset;
+    }
+
+    // Calls fn(chunk, chunk_size, first_index) for every contiguous run of elements, in order.
+    // Stops early (and returns true) as soon as fn returns true.
+    template<typename Fn>
+    bool for_each_chunk(Fn fn) const {
+        size_t first = 0;
+        for (size_t b = 0 ; b < m_num_blocks && first < m_size ; b++) {
+            size_t n = std::min(block_capacity(b), m_size - first);
+            if (fn(m_blocks[b], n, first)) { return true; }
+            first += n;
+        }
+        return false;
+    }
+
+    void destroy_all() {
+        for_each_chunk([](T* chunk, size_t n, size_t) { std::destroy_n(chunk, n); return false; });
+        for (size_t b = 0 ; b < m_num_blocks ; b++) {
+            ::operator delete(m_blocks[b]);
+        }
+        m_size = 0;
+        m_num_blocks = 0;
+    }
+
+public:
+    SegmentedVec() : m_size(0), m_num_blocks(0), m_blocks() {}
+
+    ~SegmentedVec() {
+        destroy_all();
+    }
+
+    // Copy constructor (deep copy)
+    SegmentedVec(const SegmentedVec& other) : SegmentedVec() {
+        other.for_each_chunk([this](T* chunk, size_t n, size_t) {
+            for (size_t i = 0 ; i < n ; i++) { push_back(chunk[i]); }
+            return false;
+        });
+    }
+
+    // Copy assignment operator
+    SegmentedVec& operator=(const SegmentedVec& other) {
+        if (this != &other) {
+            SegmentedVec tmp(other);
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    // Move constructor: the blocks change owner, the elements do not move
+    SegmentedVec(SegmentedVec&& other) noexcept : SegmentedVec() {
+        swap(other);
+    }
+
+    // Move assignment operator
+    SegmentedVec& operator=(SegmentedVec&& other) noexcept {
+        if (this != &other) {
+            destroy_all();
+            swap(other);
+        }
+        return *this;
+    }
+
+    // @returns Returns the number of elements
+    size_t size() const { return m_size; }
+
+    // @returns Returns the number of elements that fit in the allocated blocks
+    size_t capacity() const { return FIRST_BLOCK * ((size_t(1) << m_num_blocks) - 1); }
+
+    // @returns Returns a reference to the element at index i (unchecked).
+    // The reference stays valid until the element is removed.
+    T& operator[](size_t i) { return *slot(i); }
+    const T& operator[](size_t i) const { return *slot(i); }
+
+    // @return Returns the value at index i.
+    // @throws Throws std::out_of_range if out of bounds.
+    T at(size_t i) const {
+        if (i >= m_size) {
+            throw std::out_of_range("Attempting to access elements which are out of range.");
+        }
+        return *slot(i);
+    }
+
+    // Check if the array contains a value
+    // @returns Returns true if an element with value val exists in the array
+    bool contains(const T& val) const {
+        return find_first(val) != -1;
+    }
+
+    // Finds the index of a value in the array
+    // @returns Returns the index of the first occurrence of val
+    // @returns Returns -1 if val does not exist in the array
+    int find_first(const T& val) const {
+        int found = -1;
+        for_each_chunk([&](T* chunk, size_t n, size_t first) {
+            T* it = std::find(chunk, chunk + n, val);
+            if (it == chunk + n) { return false; }
+            found = static_cast<int>(first + (it - chunk));
+            return true;
+        });
+        return found;
+    }
+
+    // Finds all indices of a value in the array
+    // @returns Returns an std::vector with the indices of the val (empty if there are none)
+    std::vector<size_t> find_all(const T& val) const {
+        std::vector<size_t> idxs = {};
+        for_each_chunk([&](T* chunk, size_t n, size_t first) {
+            for (size_t i = 0 ; i < n ; i++) {
+                if (chunk[i] == val) { idxs.push_back(first + i); }
+            }
+            return false;
+        });
+        return idxs;
+    }
+
+    // Appends an element to the back of the array
+    void push_back(const T& val) {
+        emplace_back(val);
+    }
+
+    void push_back(T&& val) {
+        emplace_back(std::move(val));
+    }
+
+    // Constructs an element in place at the back of the array.
+    // At most one block is allocated; no existing element is moved.
+    // @returns Returns a reference to the new element
+    template<typename... Args>
+    T& emplace_back(Args&&... args) {
+        size_t block, offset;
+        locate(m_size, block, offset);
+        if (block == m_num_blocks) {
+            m_blocks[block] = static_cast<T*>(::operator new(block_capacity(block) * sizeof(T)));
+            m_num_blocks++;
+        }
+        T* p = new (m_blocks[block] + offset) T(std::forward<Args>(args)...);
+        m_size++;
+        return *p;
+    }
+
+    // Removes the last element (its block is kept for reuse)
+    // @throws out_of_range if the array is empty
+    void pop_back() {
+        if (m_size == 0) { throw std::out_of_range("Called pop_back on an empty array"); }
+        m_size--;
+        slot(m_size)->~T();
+    }
+
+    // Frees the blocks past the one holding the last element
+    void shrink_to_fit() {
+        size_t used_blocks = 0;
+        if (m_size > 0) {
+            size_t offset;
+            locate(m_size - 1, used_blocks, offset);
+            used_blocks++;
+        }
+        while (m_num_blocks > used_blocks) {
+            m_num_blocks--;
+            ::operator delete(m_blocks[m_num_blocks]);
+        }
+    }
+
+    // helper function to swap the contents of two arrays
+    void swap(SegmentedVec& other) noexcept {
+        std::swap(m_size, other.m_size);
+        std::swap(m_num_blocks, other.m_num_blocks);
+        std::swap(m_blocks, other.m_blocks);
+    }
+
+    // @overload Overload for the stream insertion operator, to print the contents of the array
+    friend std::ostream& operator<<(std::ostream& os, const SegmentedVec& vec) {
+        os << "******** SEGMENTED VEC ********\n";
+        os << "m_size = " << vec.m_size << " | blocks = " << vec.m_num_blocks
+           << " | capacity = " << vec.capacity() << std::endl;
+        os << "[";
+        for (size_t i = 0 ; i < vec.m_size ; i++) {
+            os << (i == 0 ? "" : ", ") << vec[i];
+        }
+        os << "]\n" << std::endl;
+        return os;
+    }
+};
+
+
+// Appends n elements and reports the mean and worst single-append latency
+template<typename VecType>
+void benchmarkAppendLatency(const std::string& name, size_t n) {
+    VecType v;
+    double worst_ns = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0 ; i < n ; i++) {
+        auto before = std::chrono::steady_clock::now();
+        v.push_back(static_cast<int>(i));
+        auto after = std::chrono::steady_clock::now();
+        worst_ns = std::max(worst_ns, std::chrono::duration<double, std::nano>(after - before).count());
+    }
+    double total_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    std::cout << name << " x " << n << ": mean " << total_ns / n << " ns/append (incl. timing), worst "
+              << worst_ns / 1000 << " us" << std::endl;
+}
+
+
+int main() {
+    SegmentedVec<int> v;
+    for (int i = 0 ; i < 20 ; i++) {
+        v.push_back(i);
+    }
+    int* tenth = &v[10];
+    for (int i = 20 ; i < 1000 ; i++) {
+        v.push_back(i); // several new blocks, but v[10] stays where it is
+    }
+    std::cout << "pointer still valid: " << (tenth == &v[10]) << " value " << *tenth << std::endl;
+    std::cout << "find_first(999) = " << v.find_first(999) << " | contains(1000) = " << v.contains(1000) << std::endl;
+
+    for (int i = 0 ; i < 990 ; i++) {
+        v.pop_back();
+    }
+    v.shrink_to_fit();
+    std::cout << v;
+
+    benchmarkAppendLatency<std::vector<int>>("std::vector<int>", 20000000);
+    benchmarkAppendLatency<SegmentedVec<int>>("SegmentedVec<int>", 20000000);
+}
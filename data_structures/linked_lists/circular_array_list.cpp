@@ -0,0 +1,368 @@
+/**
+ * A fixed-capacity circular list stored in a contiguous ring buffer, for round-robin workloads
+ * over a bounded set. The capacity is rounded up to a power of two, so wrapping an index around
+ * the ring is a bit mask. Elements sit next to each other in memory, no element needs its own
+ * allocation, and rotating a full ring only moves the head index.
+ */
+
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <list>
+#include <stdexcept>
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <chrono>
+#include <memory>
+#include <random>
+#include <new>
+
+
+template<typename T>
+class CircularArrayList {
+private:
+    T* data;          // capacity slots; only the count slots starting at head hold constructed elements
+    size_t mask;      // capacity - 1
+    size_t head;
+    size_t count;
+
+    // Returns the slot of the element at logical index i (0 = head).
+    T* slot(size_t i) const {
+        return data + ((head + i) & mask);
+    }
+
+    static size_t roundUpToPowerOfTwo(size_t n) {
+        size_t capacity = 1;
+        while (capacity < n) {
+            capacity <<= 1;
+        }
+        return capacity;
+    }
+
+    // Throws std::length_error if there is no free slot.
+    void checkNotFull() const {
+        if (isFull()) {
+            throw std::length_error("CircularArrayList is full.");
+        }
+    }
+
+    // Removes the element at logical index idx, shifting whichever side of it is shorter.
+    void eraseAt(size_t idx) {
+        if (idx < count / 2) {
+            for (size_t i = idx; i > 0; i--) {
+                *slot(i) = std::move(*slot(i - 1));
+            }
+            slot(0)->~T();
+            head = (head + 1) & mask;
+        } else {
+            for (size_t i = idx; i + 1 < count; i++) {
+                *slot(i) = std::move(*slot(i + 1));
+            }
+            slot(count - 1)->~T();
+        }
+        count--;
+    }
+
+public:
+    // Creates an empty list holding up to capacity elements (rounded up to a power of two).
+    explicit CircularArrayList(size_t capacity)
+        : data(nullptr), mask(roundUpToPowerOfTwo(capacity) - 1), head(0), count(0) {
+        data = static_cast<T*>(::operator new((mask + 1) * sizeof(T)));
+    }
+
+    // Instantiates a list with the initial values provided, and room for at least capacity elements.
+    CircularArrayList(const std::vector<T>& values, size_t capacity = 0)
+        : CircularArrayList(std::max(values.size(), capacity)) {
+        for (const T& value : values) {
+            insertAtTail(value);
+        }
+    }
+
+    ~CircularArrayList() {
+        if (data == nullptr)
+            return;
+        for (size_t i = 0; i < count; i++) {
+            slot(i)->~T();
+        }
+        ::operator delete(data);
+    }
+
+    // Copy constructor (deep copy, with the same capacity).
+    CircularArrayList(const CircularArrayList& other) : CircularArrayList(other.capacity()) {
+        for (size_t i = 0; i < other.count; i++) {
+            insertAtTail(*other.slot(i));
+        }
+    }
+
+    // Assignment operator.
+    CircularArrayList& operator=(const CircularArrayList& other) {
+        if (this != &other) {
+            CircularArrayList tmp(other);
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    // Move constructor: takes over the buffer of other, which is left without one (capacity 0).
+    CircularArrayList(CircularArrayList&& other) noexcept
+        : data(other.data), mask(other.mask), head(other.head), count(other.count) {
+        other.data = nullptr;
+        other.mask = size_t(-1); // capacity() == 0, so every insertion throws
+        other.head = 0;
+        other.count = 0;
+    }
+
+    CircularArrayList& operator=(CircularArrayList&& other) noexcept {
+        if (this != &other) {
+            CircularArrayList tmp(std::move(other));
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    // Returns the number of elements in the list.
+    int countNodes() const {
+        return static_cast<int>(count);
+    }
+
+    size_t capacity() const {
+        return mask + 1;
+    }
+
+    bool isFull() const {
+        return count == capacity();
+    }
+
+    // Returns the element at logical index idx (0 = head).
+    // Throws std::out_of_range if idx >= number of elements.
+    T& at(size_t idx) {
+        if (idx >= count)
+            throw std::out_of_range("Index is out of range.");
+        return *slot(idx);
+    }
+
+    // Returns the head element, i.e. whose turn it is in a round-robin.
+    // Throws std::out_of_range if the list is empty.
+    T& front() {
+        return at(0);
+    }
+
+    // Throws std::length_error if the list is full.
+    void insertAtHead(const T& v) {
+        checkNotFull();
+        size_t newHead = (head - 1) & mask;
+        new (data + newHead) T(v);
+        head = newHead;
+        count++;
+    }
+
+    // Throws std::length_error if the list is full.
+    void insertAtTail(const T& v) {
+        checkNotFull();
+        new (slot(count)) T(v);
+        count++;
+    }
+
+    // Inserts v at logical index idx, shifting whichever side of idx is shorter.
+    // Throws std::invalid_argument if idx is negative, std::out_of_range if idx > number of elements,
+    // and std::length_error if the list is full.
+    void insertAtIndex(const T& v, const int idx) {
+        if (idx < 0)
+            throw std::invalid_argument("Negative index not allowed.");
+        if (static_cast<size_t>(idx) > count)
+            throw std::out_of_range("Index is out of range for insertion.");
+        checkNotFull();
+
+        size_t pos = idx;
+        if (pos == 0) {
+            insertAtHead(v);
+            return;
+        }
+        if (pos == count) {
+            insertAtTail(v);
+            return;
+        }
+
+        if (pos < count - pos) {
+            // Open a slot before the head, and move the elements before idx one place towards it.
+            head = (head - 1) & mask;
+            count++;
+            new (slot(0)) T(std::move(*slot(1)));
+            for (size_t i = 1; i < pos; i++) {
+                *slot(i) = std::move(*slot(i + 1));
+            }
+        } else {
+            // Open a slot after the tail, and move the elements from idx one place towards it.
+            count++;
+            new (slot(count - 1)) T(std::move(*slot(count - 2)));
+            for (size_t i = count - 2; i > pos; i--) {
+                *slot(i) = std::move(*slot(i - 1));
+            }
+        }
+        *slot(pos) = v;
+    }
+
+    // Rotates the list by steps places: the element at index steps becomes the head (negative steps rotate
+    // the other way). O(1) when the list is full, since then only the head index moves; otherwise the
+    // min(steps, n - steps) elements that cross the gap between tail and head are moved.
+    void rotate(long long steps = 1) {
+        if (count == 0)
+            return;
+        long long n = static_cast<long long>(count);
+        size_t forward = static_cast<size_t>(((steps % n) + n) % n);
+
+        if (isFull()) {
+            head = (head + forward) & mask;
+            return;
+        }
+        if (forward <= count - forward) {
+            // Move the first `forward` elements to the free slots after the tail.
+            for (size_t i = 0; i < forward; i++) {
+                new (slot(count)) T(std::move(*slot(0)));
+                slot(0)->~T();
+                head = (head + 1) & mask;
+            }
+        } else {
+            // Move the last `count - forward` elements to the free slots before the head.
+            for (size_t i = forward; i < count; i++) {
+                size_t newHead = (head - 1) & mask;
+                new (data + newHead) T(std::move(*slot(count - 1)));
+                slot(count - 1)->~T();
+                head = newHead;
+            }
+        }
+    }
+
+    // Returns true if an element equal to v exists in the list, false otherwise.
+    bool contains(const T& v) const {
+        for (size_t i = 0; i < count; i++) {
+            if (*slot(i) == v) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Deletes the first element equal to v.
+    // Returns true if a deletion occurred, false if the value was not found.
+    bool deleteFirstInstance(const T& v) {
+        for (size_t i = 0; i < count; i++) {
+            if (*slot(i) == v) {
+                eraseAt(i);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Deletes all elements equal to v, compacting the rest in one pass.
+    void deleteAllInstances(const T& v) {
+        size_t kept = 0;
+        for (size_t i = 0; i < count; i++) {
+            if (*slot(i) == v)
+                continue;
+            if (kept != i) {
+                *slot(kept) = std::move(*slot(i));
+            }
+            kept++;
+        }
+        for (size_t i = kept; i < count; i++) {
+            slot(i)->~T();
+        }
+        count = kept;
+    }
+
+    // Returns the number of elements equal to v.
+    int countInstances(const T& v) const {
+        int counter = 0;
+        for (size_t i = 0; i < count; i++) {
+            counter += *slot(i) == v;
+        }
+        return counter;
+    }
+
+    // Reverses the list in-place.
+    void reverse() {
+        if (count < 2)
+            return;
+        for (size_t i = 0, j = count - 1; i < j; i++, j--) {
+            std::swap(*slot(i), *slot(j));
+        }
+    }
+
+    // Prints the list to the console, with the buffer slot and value of each element.
+    void print() const {
+        if (count == 0) {
+            std::cout << "Empty list" << std::endl;
+            return;
+        }
+        for (size_t i = 0; i < count; i++) {
+            std::ostringstream oss;
+            oss << "[RingSlot | slot: " << ((head + i) & mask) << " val: " << *slot(i) << "]\n";
+            std::cout << oss.str();
+        }
+    }
+
+    // Helper function to swap the contents of two CircularArrayList objects.
+    void swap(CircularArrayList& other) noexcept {
+        std::swap(data, other.data);
+        std::swap(mask, other.mask);
+        std::swap(head, other.head);
+        std::swap(count, other.count);
+    }
+};
+
+
+// Times `turns` round-robin turns: read whose turn it is, then rotate by one.
+template<typename Turn>
+void benchmarkRoundRobin(const std::string& name, int turns, Turn turn) {
+    long long checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < turns; i++) {
+        checksum += turn();
+    }
+    std::cout << name << ": " << std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / turns
+              << " ns per turn (checksum " << checksum << ")" << std::endl;
+}
+
+int main() {
+    CircularArrayList<std::string> ring({"a", "b", "c"}, 6); // capacity 8
+    ring.insertAtHead("z");
+    ring.insertAtIndex("m", 2);
+    ring.rotate(2);
+    ring.reverse();
+    ring.print();
+    std::cout << "capacity = " << ring.capacity() << " | contains(\"m\") = " << ring.contains("m") << std::endl;
+
+    const int SIZE = 4096;
+    const int TURNS = 50000000;
+    std::vector<int> values(SIZE);
+    for (int i = 0; i < SIZE; i++) {
+        values[i] = i;
+    }
+
+    CircularArrayList<int> full(values); // a power-of-two set fills the ring, so rotation only moves head
+    benchmarkRoundRobin("CircularArrayList (full)", TURNS, [&] {
+        int v = full.front();
+        full.rotate();
+        return v;
+    });
+
+    CircularArrayList<int> partial(values, SIZE + 1); // one element moves across the gap per turn
+    benchmarkRoundRobin("CircularArrayList (partial)", TURNS, [&] {
+        int v = partial.front();
+        partial.rotate();
+        return v;
+    });
+
+    // A node per element, as in CircularLinkedList; nodes are shuffled in memory like a long-lived list's.
+    std::vector<int> shuffled = values;
+    std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(1));
+    std::list<int> nodes(shuffled.begin(), shuffled.end());
+    benchmarkRoundRobin("std::list (splice head to tail)", TURNS, [&] {
+        int v = nodes.front();
+        nodes.splice(nodes.end(), nodes, nodes.begin());
+        return v;
+    });
+}
@@ -3,6 +3,9 @@
 #include <vector>
 #include <stdexcept>
 #include <algorithm>
+#include <string>
+#include <utility>
+#include <new>
 
 template<typename T>
 struct ListNode {
@@ -18,17 +21,135 @@ struct ListNode {
     }
 };
 
+// Slab allocator for list nodes.
+// Nodes are carved out of contiguous pages, and freed nodes go onto a free list to be reused,
+// so inserting and deleting does not call malloc/free, and nodes allocated together sit together in memory.
+// A pool can be shared by several lists; it must outlive them, and is not thread-safe.
+template<typename Node>
+class NodePool {
+private:
+    // A free slot holds the link to the next free slot, a used slot holds a node.
+    union Slot {
+        Slot* nextFree;
+        alignas(Node) unsigned char storage[sizeof(Node)];
+    };
+
+    static const size_t PAGE_BYTES = 64 * 1024;
+    static const size_t SLOTS_PER_PAGE = PAGE_BYTES / sizeof(Slot) > 0 ? PAGE_BYTES / sizeof(Slot) : 1;
+
+    std::vector<Slot*> pages;
+    Slot* freeList;   // most recently freed slot first
+    Slot* bump;       // next never-used slot in the newest page
+    Slot* bumpEnd;
+
+public:
+    NodePool() : freeList(nullptr), bump(nullptr), bumpEnd(nullptr) {}
+
+    // Every node must have been destroyed before the pool is.
+    ~NodePool() {
+        for (Slot* page : pages) {
+            ::operator delete(page);
+        }
+    }
+
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+
+    // Constructs a node in a free slot, allocating a new page only when there is none.
+    template<typename... Args>
+    Node* create(Args&&... args) {
+        Slot* slot;
+        if (freeList != nullptr) {
+            slot = freeList;
+            freeList = freeList->nextFree;
+        }
+        else {
+            if (bump == bumpEnd) {
+                bump = static_cast<Slot*>(::operator new(SLOTS_PER_PAGE * sizeof(Slot)));
+                bumpEnd = bump + SLOTS_PER_PAGE;
+                pages.push_back(bump);
+            }
+            slot = bump++;
+        }
+        return new (slot->storage) Node(std::forward<Args>(args)...);
+    }
+
+    // Destroys a node created by this pool and puts its slot on the free list.
+    void destroy(Node* node) {
+        node->~Node();
+        Slot* slot = reinterpret_cast<Slot*>(node);
+        slot->nextFree = freeList;
+        freeList = slot;
+    }
+};
+
+
 template<typename T>
 class CircularLinkedList {
 private:
     ListNode<T>* head;
     ListNode<T>* tail;
+    NodePool<ListNode<T>>* pool; // Where nodes come from; nullptr means plain new/delete.
+    int nodeCount;               // Kept up to date by createNode / destroyNode, which every node goes through.
+
+    // Allocates a node, from the pool if the list has one.
+    // The count is only bumped once the node exists, so it stays right if the allocation or the copy throws.
+    ListNode<T>* createNode(const T& v, ListNode<T>* next) {
+        ListNode<T>* node = pool != nullptr ? pool->create(v, next) : new ListNode<T>(v, next);
+        nodeCount++;
+        return node;
+    }
+
+    // Frees a node allocated by createNode.
+    void destroyNode(ListNode<T>* node) {
+        nodeCount--;
+        if (pool != nullptr) {
+            pool->destroy(node);
+            return;
+        }
+        delete node;
+    }
+
+    // Returns the last node of the non-decreasing run starting at first (the chain must be null-terminated).
+    static ListNode<T>* runEnd(ListNode<T>* first) {
+        while (first->nextNode != nullptr && !(first->nextNode->val < first->val)) {
+            first = first->nextNode;
+        }
+        return first;
+    }
+
+    // Merges two sorted, null-terminated chains (given with their last nodes) by relinking them,
+    // and links the result to *link. On ties the node from left goes first, so merging is stable.
+    // Returns the last node of the merged chain.
+    static ListNode<T>* mergeRuns(ListNode<T>* left, ListNode<T>* leftEnd, ListNode<T>* right, ListNode<T>* rightEnd,
+                                  ListNode<T>** link) {
+        while (left != nullptr && right != nullptr) {
+            if (right->val < left->val) {
+                *link = right;
+                right = right->nextNode;
+            } else {
+                *link = left;
+                left = left->nextNode;
+            }
+            link = &(*link)->nextNode;
+        }
+        // The run that is not used up is already in order, so it is appended as a whole.
+        if (left != nullptr) {
+            *link = left;
+            return leftEnd;
+        }
+        *link = right;
+        return rightEnd;
+    }
 
 public:
-    CircularLinkedList() : head(nullptr), tail(nullptr) {}
+    // Creates an empty list; if a pool is given, all nodes of the list are allocated from it.
+    explicit CircularLinkedList(NodePool<ListNode<T>>* nodePool = nullptr) : head(nullptr), tail(nullptr), pool(nodePool), nodeCount(0) {}
 
     // Instantiates a circular linked list, with the initial values provided.
-    CircularLinkedList(const std::vector<T>& values) : head(nullptr), tail(nullptr) {
+    // Delegating makes the list complete before any node is added, so the destructor frees them if a copy throws.
+    CircularLinkedList(const std::vector<T>& values, NodePool<ListNode<T>>* nodePool = nullptr)
+        : CircularLinkedList(nodePool) {
         createList(values);
     }
 
@@ -40,13 +161,14 @@ public:
         ListNode<T>* current = head;
         while (current != nullptr) {
             ListNode<T>* tmp = current->nextNode;
-            delete current;
+            destroyNode(current);
             current = tmp;
         }
     }
 
-    // Copy constructor (deep copy)
-    CircularLinkedList(const CircularLinkedList& other) : head(nullptr), tail(nullptr) {
+    // Copy constructor (deep copy). The copy allocates its nodes from the same pool as other,
+    // and frees them if a copy throws.
+    CircularLinkedList(const CircularLinkedList& other) : CircularLinkedList(other.pool) {
         if (other.head != nullptr) {
             ListNode<T>* current = other.head;
             do {
@@ -65,30 +187,40 @@ public:
         return *this;
     }
 
+    // Move constructor: takes over the nodes of other, which is left empty (using the same pool).
+    CircularLinkedList(CircularLinkedList&& other) noexcept
+        : head(other.head), tail(other.tail), pool(other.pool), nodeCount(other.nodeCount) {
+        other.head = nullptr;
+        other.tail = nullptr;
+        other.nodeCount = 0;
+    }
+
+    // Move assignment operator. Our old nodes end up in tmp, which frees them.
+    CircularLinkedList& operator=(CircularLinkedList&& other) noexcept {
+        if (this != &other) {
+            CircularLinkedList tmp(std::move(other));
+            swap(tmp);
+        }
+        return *this;
+    }
+
     // Creates a circular linked list from the provided vector.
     void createList(const std::vector<T>& values) {
         head = nullptr;
         tail = nullptr;
+        nodeCount = 0;
         for (const T& value : values) {
             insertAtTail(value);
         }
     }
 
-    // Returns the number of nodes in the circular linked list.
+    // Returns the number of nodes in the circular linked list, in O(1).
     int countNodes() const {
-        if (head == nullptr)
-            return 0;
-        int count = 0;
-        ListNode<T>* current = head;
-        do {
-            count++;
-            current = current->nextNode;
-        } while (current != head);
-        return count;
+        return nodeCount;
     }
 
     void insertAtHead(const T v) {
-        ListNode<T>* newNode = new ListNode<T>(v, nullptr);
+        ListNode<T>* newNode = createNode(v, nullptr);
         if (head == nullptr) {
             head = newNode;
             tail = newNode;
@@ -102,7 +234,7 @@ public:
     }
 
     void insertAtTail(const T v) {
-        ListNode<T>* newNode = new ListNode<T>(v, nullptr);
+        ListNode<T>* newNode = createNode(v, nullptr);
         if (head == nullptr) {
             head = newNode;
             tail = newNode;
@@ -118,15 +250,14 @@ public:
     void insertAtIndex(const T v, const int idx) {
         if (idx < 0)
             throw std::invalid_argument("Negative index not allowed.");
-        int count = countNodes();
-        if (idx > count)
+        if (idx > nodeCount)
             throw std::out_of_range("Index is out of range for insertion.");
 
         if (idx == 0) {
             insertAtHead(v);
             return;
         }
-        if (idx == count) {
+        if (idx == nodeCount) {
             insertAtTail(v);
             return;
         }
@@ -135,10 +266,103 @@ public:
         for (int i = 0; i < idx - 1; ++i) {
             current = current->nextNode;
         }
-        ListNode<T>* newNode = new ListNode<T>(v, current->nextNode);
+        ListNode<T>* newNode = createNode(v, current->nextNode);
         current->nextNode = newNode;
     }
 
+    // Moves all nodes of other into this list, so that they start at index idx, and leaves other empty.
+    // Nodes are relinked, not copied: O(1) at the head and the tail, otherwise O(idx) to walk to the position.
+    // If other allocates from a different pool, its values are copied into nodes from our pool instead (O(n)).
+    // Throws std::invalid_argument if idx is negative or other is this list,
+    // and std::out_of_range if idx > number of nodes.
+    void splice(const int idx, CircularLinkedList&& other) {
+        if (idx < 0)
+            throw std::invalid_argument("Negative index not allowed.");
+        if (idx > nodeCount)
+            throw std::out_of_range("Index is out of range for splice.");
+        if (&other == this)
+            throw std::invalid_argument("Cannot splice a list into itself.");
+
+        // A node has to be freed to the pool it came from, so nodes only change lists within a pool.
+        if (other.pool != pool) {
+            CircularLinkedList adopted(pool);
+            ListNode<T>* current = other.head;
+            for (int i = 0; i < other.nodeCount; i++) {
+                adopted.insertAtTail(std::move(current->val));
+                current = current->nextNode;
+            }
+            CircularLinkedList discarded(std::move(other)); // frees other's nodes when it goes out of scope
+            splice(idx, std::move(adopted));
+            return;
+        }
+        if (other.head == nullptr)
+            return;
+
+        if (head == nullptr) {
+            swap(other);
+            return;
+        }
+
+        // The node after which other is linked in; inserting after the tail at index 0 makes other the new head.
+        ListNode<T>* before = tail;
+        if (idx > 0 && idx < nodeCount) {
+            before = head;
+            for (int i = 0; i < idx - 1; ++i) {
+                before = before->nextNode;
+            }
+        }
+        other.tail->nextNode = before->nextNode;
+        before->nextNode = other.head;
+        if (idx == 0) {
+            head = other.head;
+        } else if (before == tail) {
+            tail = other.tail;
+        }
+
+        nodeCount += other.nodeCount;
+        other.head = nullptr;
+        other.tail = nullptr;
+        other.nodeCount = 0;
+    }
+
+    // Moves all nodes of other to the end of this list in O(1) (see splice), leaving other empty.
+    void append(CircularLinkedList&& other) {
+        splice(nodeCount, std::move(other));
+    }
+
+    // Detaches the nodes from index idx onwards and returns them as a new circular list (using the same pool).
+    // Nothing is copied; it takes O(idx) to walk to the split point.
+    // Throws std::invalid_argument if idx is negative and std::out_of_range if idx > number of nodes.
+    CircularLinkedList split_at(const int idx) {
+        if (idx < 0)
+            throw std::invalid_argument("Negative index not allowed.");
+        if (idx > nodeCount)
+            throw std::out_of_range("Index is out of range for split.");
+
+        CircularLinkedList suffix(pool);
+        if (idx == nodeCount)
+            return suffix;
+        if (idx == 0) {
+            swap(suffix);
+            return suffix;
+        }
+
+        // The last node which stays in this list.
+        ListNode<T>* last = head;
+        for (int i = 0; i < idx - 1; ++i) {
+            last = last->nextNode;
+        }
+        suffix.head = last->nextNode;
+        suffix.tail = tail;
+        suffix.nodeCount = nodeCount - idx;
+        suffix.tail->nextNode = suffix.head;
+
+        last->nextNode = head;
+        tail = last;
+        nodeCount = idx;
+        return suffix;
+    }
+
     // Returns true if a node with the value v exists in the list, false otherwise.
     bool contains(const T v) const {
         if (head == nullptr)
@@ -163,14 +387,14 @@ public:
         // Special case for deleting the head node.
         if (head->val == v) {
             if (head == tail) {
-                delete head;
+                destroyNode(head);
                 head = nullptr;
                 tail = nullptr;
             } else {
                 ListNode<T>* temp = head;
                 head = head->nextNode;
                 tail->nextNode = head;  // update tail's pointer
-                delete temp;
+                destroyNode(temp);
             }
             return true;
         }
@@ -184,7 +408,7 @@ public:
                     tail = current;
                 }
                 current->nextNode = temp->nextNode;
-                delete temp;
+                destroyNode(temp);
                 return true;
             }
             current = current->nextNode;
@@ -236,6 +460,55 @@ public:
         tail->nextNode = head;
     }
 
+    // Sorts the list in ascending order (using operator<) by relinking nodes, without allocating.
+    // Bottom-up merge sort over the natural runs of the list, so a sorted list takes one O(n)
+    // traversal and the worst case is O(n log n). Stable.
+    void sort() {
+        if (head == nullptr || head == tail)
+            return;
+
+        // Break the circular link while sorting, as in reverse().
+        tail->nextNode = nullptr;
+
+        // Runs are merged like a binary counter: pending[i] is either empty or a sorted chain made of 2^i runs.
+        // Merges happen while the runs involved are still recent, hence in cache, instead of once per pass over
+        // the whole list. The slots live on the stack, so nothing is allocated.
+        ListNode<T>* pending[64] = {};
+        ListNode<T>* pendingEnd[64];
+
+        ListNode<T>* rest = head;
+        while (rest != nullptr) {
+            ListNode<T>* run = rest;
+            ListNode<T>* runLast = runEnd(run);
+            rest = runLast->nextNode;
+            runLast->nextNode = nullptr;
+
+            int i = 0;
+            for (; pending[i] != nullptr; i++) {
+                runLast = mergeRuns(pending[i], pendingEnd[i], run, runLast, &run);
+                pending[i] = nullptr;
+            }
+            pending[i] = run;
+            pendingEnd[i] = runLast;
+        }
+
+        // Fold the remaining slots together; a higher slot holds earlier nodes, so it goes on the left.
+        head = nullptr;
+        for (int i = 0; i < 64; i++) {
+            if (pending[i] == nullptr) {
+                continue;
+            }
+            if (head == nullptr) {
+                head = pending[i];
+                tail = pendingEnd[i];
+            } else {
+                tail = mergeRuns(pending[i], pendingEnd[i], head, tail, &head);
+            }
+        }
+
+        tail->nextNode = head;
+    }
+
     // Prints the circular linked list to the console.
     // Each node is printed with its memory address and value.
     void print() const {
@@ -254,5 +527,7 @@ public:
     void swap(CircularLinkedList& other) noexcept {
         std::swap(head, other.head);
         std::swap(tail, other.tail);
+        std::swap(pool, other.pool); // The nodes stay with the pool they came from.
+        std::swap(nodeCount, other.nodeCount);
     }
 };
\ No newline at end of file
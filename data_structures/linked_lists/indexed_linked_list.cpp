@@ -0,0 +1,330 @@
+/**
+ * Indexed linked list: a singly linked list with a skip-list index layered on top of it.
+ * Every node is on the bottom level (the ordinary list); a random subset of nodes is also
+ * linked on higher levels, each link recording how many positions it skips. Reaching
+ * position i then takes O(log n) expected steps, so positional insert, delete and access
+ * are O(log n) instead of the O(n) walk of LinkedList.
+ */
+
+#include <iostream>
+#include <string>
+#include <sstream>
+#include <vector>
+#include <list>
+#include <stdexcept>
+#include <utility>
+#include <chrono>
+#include <random>
+#include <iterator>
+#include <cstdint>
+#include <new>
+
+
+template<typename T>
+class IndexedLinkedList {
+private:
+    static const int MAX_LEVEL = 32;
+
+    struct IndexedNode;
+
+    // a link on one level: the next node on that level, and how many positions forward it is.
+    // a link with no next node still counts the positions up to one past the last element.
+    struct Link {
+        IndexedNode* next;
+        size_t width;
+    };
+
+    // a node stores its links (one per level it is on) right after itself, in the same allocation
+    struct IndexedNode {
+        T val;
+        int height;
+        Link* links;
+
+        IndexedNode(const T& v, int h) : val(v), height(h), links(nullptr) {}
+    };
+
+    static const size_t LINKS_OFFSET = (sizeof(IndexedNode) + alignof(Link) - 1) / alignof(Link) * alignof(Link);
+
+    Link headLinks[MAX_LEVEL]; // the head is not a node, only a set of links, so T needs no default value
+    int levels;                // number of levels in use
+    size_t nodeCount;
+    uint64_t rngState;         // xorshift state for the node heights
+
+    // this function picks a node height: level k is used with probability 1/2^k
+    int randomHeight() {
+        rngState ^= rngState << 13;
+        rngState ^= rngState >> 7;
+        rngState ^= rngState << 17;
+        int height = 1 + __builtin_ctzll(rngState | (uint64_t(1) << (MAX_LEVEL - 1)));
+        return height < MAX_LEVEL ? height : MAX_LEVEL;
+    }
+
+    static IndexedNode* createNode(const T& v, int height) {
+        void* memory = ::operator new(LINKS_OFFSET + height * sizeof(Link));
+        IndexedNode* node = new (memory) IndexedNode(v, height);
+        node->links = reinterpret_cast<Link*>(static_cast<unsigned char*>(memory) + LINKS_OFFSET);
+        return node;
+    }
+
+    static void destroyNode(IndexedNode* node) {
+        node->~IndexedNode();
+        ::operator delete(node);
+    }
+
+    // this function returns the links of a node, or the head links for nullptr
+    Link* linksOf(IndexedNode* node) {
+        return node == nullptr ? headLinks : node->links;
+    }
+
+    // this function finds, on every level, the last node before position idx (nullptr = the head),
+    // and how many elements precede it. this is the O(log n) descent all positional operations share
+    void findPredecessors(size_t idx, IndexedNode** before, size_t* beforePos) {
+        IndexedNode* current = nullptr;
+        size_t pos = 0; // number of elements up to and including current
+        for (int level = levels - 1; level >= 0; level--) {
+            Link* link = &linksOf(current)[level];
+            while (link->next != nullptr && pos + link->width <= idx) {
+                pos += link->width;
+                current = link->next;
+                link = &current->links[level];
+            }
+            before[level] = current;
+            beforePos[level] = pos;
+        }
+    }
+
+    void clear() {
+        IndexedNode* current = headLinks[0].next;
+        while (current != nullptr) {
+            IndexedNode* tmp = current->links[0].next;
+            destroyNode(current);
+            current = tmp;
+        }
+        levels = 1;
+        nodeCount = 0;
+        headLinks[0] = Link{nullptr, 1};
+    }
+
+public:
+    IndexedLinkedList() : levels(1), nodeCount(0), rngState(0x9E3779B97F4A7C15ull) {
+        headLinks[0] = Link{nullptr, 1};
+    }
+
+    IndexedLinkedList(const std::vector<T>& values) : IndexedLinkedList() {
+        for (const T& value : values) {
+            insertAtTail(value);
+        }
+    }
+
+    // destructor should deallocate all memory used by the list
+    ~IndexedLinkedList() {
+        clear();
+    }
+
+    // copy constructor (deep copy); the copy draws its own node heights
+    IndexedLinkedList(const IndexedLinkedList& other) : IndexedLinkedList() {
+        for (IndexedNode* current = other.headLinks[0].next; current != nullptr; current = current->links[0].next) {
+            insertAtTail(current->val);
+        }
+    }
+
+    // assignment operator
+    IndexedLinkedList& operator=(const IndexedLinkedList& other) {
+        if (this != &other) {
+            IndexedLinkedList tmp(other);
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    // this function returns the number of nodes in the list (O(1))
+    int countNodes() const {
+        return static_cast<int>(nodeCount);
+    }
+
+    // this function inserts a node at a specified index of the list in O(log n) expected time
+    // @throws invalid argument if index is negative
+    // @throws out_of_range error if provided index > number of nodes in list
+    void insertAtIndex(const T v, const int idx) {
+        if (idx < 0) {
+            throw std::invalid_argument("Negative index not allowed.");
+        }
+        if (static_cast<size_t>(idx) > nodeCount) {
+            throw std::out_of_range("index is out of range for insertion.");
+        }
+
+        int height = randomHeight();
+        // new levels start out as a single link from the head to one past the end
+        for (; levels < height; levels++) {
+            headLinks[levels] = Link{nullptr, nodeCount + 1};
+        }
+
+        IndexedNode* before[MAX_LEVEL] = {};
+        size_t beforePos[MAX_LEVEL];
+        findPredecessors(idx, before, beforePos);
+
+        IndexedNode* node = createNode(v, height);
+        for (int level = 0; level < levels; level++) {
+            Link& link = linksOf(before[level])[level];
+            if (level < height) {
+                // the new node splits the link: it is (idx - beforePos + 1) positions from its predecessor
+                size_t toNew = idx - beforePos[level] + 1;
+                node->links[level] = Link{link.next, link.width - toNew + 1};
+                link = Link{node, toNew};
+            }
+            else {
+                link.width++; // the link now skips over one more node
+            }
+        }
+        nodeCount++;
+    }
+
+    // this function inserts a node at the head of the list
+    void insertAtHead(const T v) {
+        insertAtIndex(v, 0);
+    }
+
+    // this function inserts a node at the tail of the list
+    void insertAtTail(const T v) {
+        insertAtIndex(v, static_cast<int>(nodeCount));
+    }
+
+    // this function deletes the node at a specified index in O(log n) expected time
+    // @throws out_of_range error if there is no node at idx
+    void deleteAtIndex(const int idx) {
+        if (idx < 0 || static_cast<size_t>(idx) >= nodeCount) {
+            throw std::out_of_range("index is out of range for deletion.");
+        }
+
+        IndexedNode* before[MAX_LEVEL] = {};
+        size_t beforePos[MAX_LEVEL];
+        findPredecessors(idx, before, beforePos);
+
+        IndexedNode* target = linksOf(before[0])[0].next;
+        for (int level = 0; level < levels; level++) {
+            Link& link = linksOf(before[level])[level];
+            if (level < target->height) {
+                link = Link{target->links[level].next, link.width + target->links[level].width - 1};
+            }
+            else {
+                link.width--;
+            }
+        }
+        destroyNode(target);
+        nodeCount--;
+
+        while (levels > 1 && headLinks[levels - 1].next == nullptr) {
+            levels--;
+        }
+    }
+
+    // this function returns a reference to the value at a specified index in O(log n) expected time
+    // @throws out_of_range error if there is no node at idx
+    T& at(const int idx) {
+        if (idx < 0 || static_cast<size_t>(idx) >= nodeCount) {
+            throw std::out_of_range("index is out of range.");
+        }
+        IndexedNode* before[MAX_LEVEL] = {};
+        size_t beforePos[MAX_LEVEL];
+        findPredecessors(idx, before, beforePos);
+        return linksOf(before[0])[0].next->val;
+    }
+
+    // this function returns the index of the first node with the value v, or -1 if there is none
+    int indexOf(const T v) const {
+        int idx = 0;
+        for (IndexedNode* current = headLinks[0].next; current != nullptr; current = current->links[0].next, idx++) {
+            if (current->val == v) {
+                return idx;
+            }
+        }
+        return -1;
+    }
+
+    // this function returns true if the list contains a node with the value v, false otherwise
+    bool contains(const T v) const {
+        return indexOf(v) != -1;
+    }
+
+    // this function deletes the first instance of a value in the list
+    // returns true if a deletion occurred, else false
+    bool deleteFirstInstance(const T v) {
+        int idx = indexOf(v);
+        if (idx == -1) {
+            return false;
+        }
+        deleteAtIndex(idx);
+        return true;
+    }
+
+    // this function deletes all instances of a value in the list
+    void deleteAllInstances(const T v) {
+        while (deleteFirstInstance(v)) {}
+    }
+
+    // this function returns the number of the nodes with the specified value
+    int countInstances(const T v) const {
+        int counter = 0;
+        for (IndexedNode* current = headLinks[0].next; current != nullptr; current = current->links[0].next) {
+            counter += current->val == v;
+        }
+        return counter;
+    }
+
+    // this function prints the list to the terminal, with the height of each node
+    void print() const {
+        if (nodeCount == 0) {
+            std::cout << "Empty list" << std::endl;
+            return;
+        }
+        for (IndexedNode* current = headLinks[0].next; current != nullptr; current = current->links[0].next) {
+            std::ostringstream oss;
+            oss << "[IndexedNode | addr: " << current << " height: " << current->height << " val: " << current->val << "]\n";
+            std::cout << oss.str();
+        }
+    }
+
+    // helper function to swap the internals of two IndexedLinkedList objects
+    void swap(IndexedLinkedList& other) noexcept {
+        std::swap(headLinks, other.headLinks);
+        std::swap(levels, other.levels);
+        std::swap(nodeCount, other.nodeCount);
+        std::swap(rngState, other.rngState);
+    }
+};
+
+
+// this function times n inserts at random positions followed by n deletes at random positions
+template<typename Insert, typename Delete>
+void benchmarkPositional(const std::string& name, int n, Insert insertAt, Delete deleteAt) {
+    std::mt19937 rng(7);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < n; i++) {
+        insertAt(static_cast<int>(rng() % (i + 1)), i);
+    }
+    for (int i = n; i > 0; i--) {
+        deleteAt(static_cast<int>(rng() % i));
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    std::cout << name << " x " << n << ": " << ns / (2.0 * n) << " ns per positional insert/delete" << std::endl;
+}
+
+int main() {
+    IndexedLinkedList<std::string> words({"a", "c", "e"});
+    words.insertAtIndex("b", 1);
+    words.insertAtIndex("d", 3);
+    words.insertAtTail("f");
+    words.deleteAtIndex(0);
+    words.print();
+    std::cout << "at(2) = " << words.at(2) << " | indexOf(\"f\") = " << words.indexOf("f") << std::endl;
+
+    IndexedLinkedList<int> indexed;
+    benchmarkPositional("IndexedLinkedList", 1000000,
+                        [&](int idx, int v) { indexed.insertAtIndex(v, idx); },
+                        [&](int idx) { indexed.deleteAtIndex(idx); });
+
+    std::list<int> plain; // a positional walk from the head, like LinkedList::insertAtIndex
+    benchmarkPositional("std::list        ", 20000,
+                        [&](int idx, int v) { plain.insert(std::next(plain.begin(), idx), v); },
+                        [&](int idx) { plain.erase(std::next(plain.begin(), idx)); });
+}
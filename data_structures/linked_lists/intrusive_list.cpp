@@ -0,0 +1,354 @@
+/**
+ * Intrusive doubly linked list: the links live inside the user's objects (by inheriting a ListHook),
+ * so putting an object in a list neither copies it nor allocates a node. The list does not own its
+ * objects; it only links and unlinks them, and an object can be unlinked in O(1) from a reference.
+ * An object must be unlinked (or its list cleared) before the object is destroyed or moved in memory.
+ * An object can be in several lists at once by inheriting one hook per list, told apart by a tag type.
+ */
+
+#include <iostream>
+#include <string>
+#include <sstream>
+#include <vector>
+#include <list>
+#include <stdexcept>
+#include <utility>
+#include <chrono>
+
+
+// the links an object needs to be in an IntrusiveList<T, Tag>; an unlinked hook has null links
+template<typename Tag = void>
+struct ListHook {
+    ListHook* prev;
+    ListHook* nextNode;
+
+    ListHook() : prev(nullptr), nextNode(nullptr) {}
+
+    // copying an object does not copy its list membership
+    ListHook(const ListHook&) : prev(nullptr), nextNode(nullptr) {}
+    ListHook& operator=(const ListHook&) { return *this; }
+
+    bool isLinked() const {
+        return nextNode != nullptr;
+    }
+};
+
+
+template<typename T, typename Tag = void>
+class IntrusiveList {
+private:
+    using Hook = ListHook<Tag>;
+
+    // the list is circular through a sentinel hook, which is not part of any object,
+    // so head, tail and empty list need no special cases
+    Hook sentinel;
+    int nodeCount;
+
+    static Hook* hookOf(T& obj) {
+        return static_cast<Hook*>(&obj);
+    }
+
+    static T& objectOf(Hook* hook) {
+        return *static_cast<T*>(hook);
+    }
+
+    static const T& objectOf(const Hook* hook) {
+        return *static_cast<const T*>(hook);
+    }
+
+    // this function links obj in front of the hook `before`
+    // @throws invalid argument if obj is already in a list using this hook
+    void linkBefore(Hook* before, T& obj) {
+        Hook* hook = hookOf(obj);
+        if (hook->isLinked()) {
+            throw std::invalid_argument("Object is already linked into a list.");
+        }
+        hook->nextNode = before;
+        hook->prev = before->prev;
+        before->prev->nextNode = hook;
+        before->prev = hook;
+        nodeCount++;
+    }
+
+    void unlinkHook(Hook* hook) {
+        hook->prev->nextNode = hook->nextNode;
+        hook->nextNode->prev = hook->prev;
+        hook->prev = nullptr;
+        hook->nextNode = nullptr;
+        nodeCount--;
+    }
+
+    // this function returns the hook at index idx (the sentinel for idx == countNodes()),
+    // walking from whichever end is closer
+    Hook* hookAt(int idx) {
+        if (idx <= nodeCount / 2) {
+            Hook* current = sentinel.nextNode;
+            for (int i = 0; i < idx; ++i) {
+                current = current->nextNode;
+            }
+            return current;
+        }
+        Hook* current = &sentinel;
+        for (int i = nodeCount; i > idx; --i) {
+            current = current->prev;
+        }
+        return current;
+    }
+
+public:
+    IntrusiveList() : nodeCount(0) {
+        sentinel.prev = &sentinel;
+        sentinel.nextNode = &sentinel;
+    }
+
+    // the destructor unlinks all objects (they are not destroyed, the list does not own them)
+    ~IntrusiveList() {
+        clear();
+    }
+
+    // an object can only be in one list per hook, so lists cannot be copied
+    IntrusiveList(const IntrusiveList&) = delete;
+    IntrusiveList& operator=(const IntrusiveList&) = delete;
+
+    // move constructor - takes over the objects of other, which is left empty
+    IntrusiveList(IntrusiveList&& other) noexcept : IntrusiveList() {
+        swap(other);
+    }
+
+    IntrusiveList& operator=(IntrusiveList&& other) noexcept {
+        if (this != &other) {
+            clear();
+            swap(other);
+        }
+        return *this;
+    }
+
+    // this function unlinks all objects from the list
+    void clear() {
+        while (!isEmpty()) {
+            unlinkHook(sentinel.nextNode);
+        }
+    }
+
+    bool isEmpty() const {
+        return nodeCount == 0;
+    }
+
+    // this function returns the number of objects in the list, in O(1)
+    int countNodes() const {
+        return nodeCount;
+    }
+
+    // this function links an object at the head of the list
+    // @throws invalid argument if obj is already in a list using this hook
+    void insertAtHead(T& obj) {
+        linkBefore(sentinel.nextNode, obj);
+    }
+
+    // this function links an object at the tail of the list
+    // @throws invalid argument if obj is already in a list using this hook
+    void insertAtTail(T& obj) {
+        linkBefore(&sentinel, obj);
+    }
+
+    // this function links an object at a specified index of the list,
+    // walking from the closer end (O(min(idx, n - idx)))
+    // @throws invalid argument if index is negative, or obj is already in a list using this hook
+    // @throws out_of_range error if provided index > number of objects in list
+    void insertAtIndex(T& obj, const int idx) {
+        if (idx < 0) {
+            throw std::invalid_argument("Negative index not allowed.");
+        }
+        if (idx > nodeCount) {
+            throw std::out_of_range("index is out of range for insertion.");
+        }
+        linkBefore(hookAt(idx), obj);
+    }
+
+    // this function unlinks an object from the list in O(1); obj must be in this list
+    void unlink(T& obj) {
+        unlinkHook(hookOf(obj));
+    }
+
+    // @throws out_of_range error if the list is empty
+    T& front() {
+        if (isEmpty()) {
+            throw std::out_of_range("Called front on an empty list.");
+        }
+        return objectOf(sentinel.nextNode);
+    }
+
+    // @throws out_of_range error if the list is empty
+    T& back() {
+        if (isEmpty()) {
+            throw std::out_of_range("Called back on an empty list.");
+        }
+        return objectOf(sentinel.prev);
+    }
+
+    // this function unlinks the head object and returns it
+    // @throws out_of_range error if the list is empty
+    T& popHead() {
+        T& obj = front();
+        unlinkHook(sentinel.nextNode);
+        return obj;
+    }
+
+    // this function returns true if the list contains an object equal to v
+    bool contains(const T& v) const {
+        for (const Hook* current = sentinel.nextNode; current != &sentinel; current = current->nextNode) {
+            if (objectOf(current) == v) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // this function unlinks the first object equal to v
+    // returns true if an object was unlinked, else false
+    bool deleteFirstInstance(const T& v) {
+        for (Hook* current = sentinel.nextNode; current != &sentinel; current = current->nextNode) {
+            if (objectOf(current) == v) {
+                unlinkHook(current);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // this function unlinks all objects equal to v, in one traversal
+    void deleteAllInstances(const T& v) {
+        Hook* current = sentinel.nextNode;
+        while (current != &sentinel) {
+            Hook* next = current->nextNode;
+            if (objectOf(current) == v) {
+                unlinkHook(current);
+            }
+            current = next;
+        }
+    }
+
+    // this function returns the number of objects equal to v
+    int countInstances(const T& v) const {
+        int counter = 0;
+        for (const Hook* current = sentinel.nextNode; current != &sentinel; current = current->nextNode) {
+            counter += objectOf(current) == v;
+        }
+        return counter;
+    }
+
+    // this function reverses the order of the list in-place, by swapping the links of every hook
+    void reverse() {
+        Hook* current = &sentinel;
+        do {
+            std::swap(current->prev, current->nextNode);
+            current = current->prev; // the old next
+        } while (current != &sentinel);
+    }
+
+    // this function prints the list to the terminal, with the address and value of each object
+    void print() const {
+        if (isEmpty()) {
+            std::cout << "Empty list" << std::endl;
+            return;
+        }
+        for (const Hook* current = sentinel.nextNode; current != &sentinel; current = current->nextNode) {
+            std::ostringstream oss;
+            oss << "[IntrusiveNode | addr: " << &objectOf(current) << " val: " << objectOf(current) << "]\n";
+            std::cout << oss.str();
+        }
+    }
+
+    // helper function to swap the contents of two lists
+    // the objects stay where they are; only the links to the two sentinels are fixed up
+    void swap(IntrusiveList& other) noexcept {
+        std::swap(sentinel.prev, other.sentinel.prev);
+        std::swap(sentinel.nextNode, other.sentinel.nextNode);
+        std::swap(nodeCount, other.nodeCount);
+        for (IntrusiveList* list : {this, &other}) {
+            if (list->nodeCount == 0) {
+                list->sentinel.prev = &list->sentinel;
+                list->sentinel.nextNode = &list->sentinel;
+            }
+            else {
+                list->sentinel.nextNode->prev = &list->sentinel;
+                list->sentinel.prev->nextNode = &list->sentinel;
+            }
+        }
+    }
+};
+
+
+// example payload: a task which is on the run queue and, at the same time, in a list of all tasks
+struct RunQueueTag {};
+struct AllTasksTag {};
+
+struct Task : ListHook<RunQueueTag>, ListHook<AllTasksTag> {
+    int id;
+    std::string name;
+
+    Task(int i, std::string n) : id(i), name(std::move(n)) {}
+
+    bool operator==(const Task& other) const {
+        return id == other.id;
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const Task& task) {
+        return os << task.id << ":" << task.name;
+    }
+};
+
+
+// this function times a round-robin scheduler loop: take the head task, run it, put it back at the tail
+template<typename Requeue>
+void benchmarkRoundRobin(const std::string& name, int rounds, Requeue requeue) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < rounds; i++) {
+        requeue();
+    }
+    std::cout << name << ": " << std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / rounds
+              << " ns per requeue" << std::endl;
+}
+
+int main() {
+    std::vector<Task> arena;
+    for (int i = 0; i < 5; i++) {
+        arena.emplace_back(i, "task" + std::to_string(i));
+    }
+
+    IntrusiveList<Task, RunQueueTag> runQueue;
+    IntrusiveList<Task, AllTasksTag> allTasks;
+    for (Task& task : arena) {
+        runQueue.insertAtTail(task);
+        allTasks.insertAtHead(task);
+    }
+    runQueue.unlink(arena[2]); // O(1), the task knows where it is
+    runQueue.insertAtIndex(arena[2], 0);
+    runQueue.reverse();
+    runQueue.print();
+    std::cout << "all tasks: " << allTasks.countNodes() << " | run queue contains task 2: " << runQueue.contains(arena[2]) << std::endl;
+    runQueue.clear();
+    allTasks.clear();
+
+    const int TASKS = 10000;
+    const int ROUNDS = 10000000;
+    std::vector<Task> tasks;
+    tasks.reserve(TASKS);
+    for (int i = 0; i < TASKS; i++) {
+        tasks.emplace_back(i, "a task name long enough to be heap allocated");
+    }
+
+    for (Task& task : tasks) {
+        runQueue.insertAtTail(task);
+    }
+    benchmarkRoundRobin("IntrusiveList", ROUNDS, [&] {
+        runQueue.insertAtTail(runQueue.popHead());
+    });
+    runQueue.clear(); // before tasks is destroyed
+
+    std::list<Task> copies(tasks.begin(), tasks.end()); // a node per task, holding a copy of it
+    benchmarkRoundRobin("std::list<Task> (pop + push copy)", ROUNDS, [&] {
+        copies.push_back(copies.front());
+        copies.pop_front();
+    });
+}
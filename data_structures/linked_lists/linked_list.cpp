@@ -5,6 +5,10 @@
 #include <cassert>
 #include <stdexcept>
 #include <utility>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <new>
 
 
 template<typename T>
@@ -12,7 +16,11 @@ struct ListNode {
     T val;
     ListNode<T>* nextNode;
 
-    ListNode(T v, ListNode<T>* next) : val(v), nextNode(next) {}
+    ListNode(T v, ListNode<T>* next) : val(std::move(v)), nextNode(next) {}
+
+    // constructs the value in place from args
+    template<typename... Args>
+    ListNode(std::in_place_t, ListNode<T>* next, Args&&... args) : val(std::forward<Args>(args)...), nextNode(next) {}
 
     // explicit conversion operator to convert a ListNode object to a string
     // debugging function, produces output of type [ListNode | addr: 0xffff val: {value}]
@@ -23,16 +31,136 @@ struct ListNode {
     }
 };
 
+// slab allocator for list nodes
+// nodes are carved out of contiguous pages, and freed nodes go onto a free list to be reused,
+// so inserting and deleting does not call malloc/free, and nodes allocated together sit together in memory.
+// a pool can be shared by several lists; it must outlive them, and is not thread-safe.
+template<typename Node>
+class NodePool {
+private:
+    // a free slot holds the link to the next free slot, a used slot holds a node
+    union Slot {
+        Slot* nextFree;
+        alignas(Node) unsigned char storage[sizeof(Node)];
+    };
+
+    static const size_t PAGE_BYTES = 64 * 1024;
+    static const size_t SLOTS_PER_PAGE = PAGE_BYTES / sizeof(Slot) > 0 ? PAGE_BYTES / sizeof(Slot) : 1;
+
+    std::vector<Slot*> pages;
+    Slot* freeList;   // most recently freed slot first
+    Slot* bump;       // next never-used slot in the newest page
+    Slot* bumpEnd;
+
+public:
+    NodePool() : freeList(nullptr), bump(nullptr), bumpEnd(nullptr) {}
+
+    // every node must have been destroyed before the pool is
+    ~NodePool() {
+        for (Slot* page : pages) {
+            ::operator delete(page);
+        }
+    }
+
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+
+    // this function constructs a node in a free slot, allocating a new page only when there is none
+    template<typename... Args>
+    Node* create(Args&&... args) {
+        Slot* slot;
+        if (freeList != nullptr) {
+            slot = freeList;
+            freeList = freeList->nextFree;
+        }
+        else {
+            if (bump == bumpEnd) {
+                bump = static_cast<Slot*>(::operator new(SLOTS_PER_PAGE * sizeof(Slot)));
+                bumpEnd = bump + SLOTS_PER_PAGE;
+                pages.push_back(bump);
+            }
+            slot = bump++;
+        }
+        return new (slot->storage) Node(std::forward<Args>(args)...);
+    }
+
+    // this function destroys a node created by this pool and puts its slot on the free list
+    void destroy(Node* node) {
+        node->~Node();
+        Slot* slot = reinterpret_cast<Slot*>(node);
+        slot->nextFree = freeList;
+        freeList = slot;
+    }
+};
+
+
 template<typename T>
 class LinkedList {
 private:
     ListNode<T>* head;
     ListNode<T>* tail;
+    NodePool<ListNode<T>>* pool; // where nodes come from; nullptr means plain new/delete
+    int nodeCount;               // kept up to date by createNode / destroyNode, which every node goes through
+
+    // this function allocates a node, from the pool if the list has one, and constructs its value from args
+    template<typename... Args>
+    ListNode<T>* createNode(ListNode<T>* next, Args&&... args) {
+        ListNode<T>* node = pool != nullptr ? pool->create(std::in_place, next, std::forward<Args>(args)...)
+                                            : new ListNode<T>(std::in_place, next, std::forward<Args>(args)...);
+        nodeCount++;
+        return node;
+    }
+
+    // this function frees a node allocated by createNode
+    void destroyNode(ListNode<T>* node) {
+        nodeCount--;
+        if (pool != nullptr) {
+            pool->destroy(node);
+            return;
+        }
+        delete node;
+    }
+
+    // this function returns the last node of the non-decreasing run starting at first
+    static ListNode<T>* runEnd(ListNode<T>* first) {
+        while (first->nextNode != nullptr && !(first->nextNode->val < first->val)) {
+            first = first->nextNode;
+        }
+        return first;
+    }
+
+    // this function merges two sorted, null-terminated chains (given with their last nodes) by relinking them,
+    // and links the result to *link. on ties the node from left goes first, so merging is stable.
+    // returns the last node of the merged chain
+    static ListNode<T>* mergeRuns(ListNode<T>* left, ListNode<T>* leftEnd, ListNode<T>* right, ListNode<T>* rightEnd,
+                                  ListNode<T>** link) {
+        while (left != nullptr && right != nullptr) {
+            if (right->val < left->val) {
+                *link = right;
+                right = right->nextNode;
+            }
+            else {
+                *link = left;
+                left = left->nextNode;
+            }
+            link = &(*link)->nextNode;
+        }
+        // whichever run is not used up is already linked in order, so it is appended as a whole
+        if (left != nullptr) {
+            *link = left;
+            return leftEnd;
+        }
+        *link = right;
+        return rightEnd;
+    }
 
 public:
-    LinkedList() : head(nullptr), tail(nullptr) {}
+    // creates an empty list; if a pool is given, all nodes of the list are allocated from it
+    explicit LinkedList(NodePool<ListNode<T>>* nodePool = nullptr) : head(nullptr), tail(nullptr), pool(nodePool), nodeCount(0) {}
 
-    LinkedList(const std::vector<T>& values) {
+    // delegating to LinkedList(nodePool) makes the list complete before any node is added, so if a copy
+    // throws, the destructor frees the nodes already added
+    LinkedList(const std::vector<T>& values, NodePool<ListNode<T>>* nodePool = nullptr) : LinkedList(nodePool) {
         this->createList(values);
     }
 
@@ -43,13 +171,14 @@ public:
 
         while (current != nullptr) {
             tmp = current->nextNode;
-            delete current;
+            destroyNode(current);
             current = tmp;
         }
     }
 
     // copy constructor - we want to implement deep copy instead of shallow copy
-    LinkedList(const LinkedList& other) : head(nullptr), tail(nullptr) {
+    // the copy allocates its nodes from the same pool as other (and, as above, frees them if a copy throws)
+    LinkedList(const LinkedList& other) : LinkedList(other.pool) {
         for (ListNode<T>* current = other.head; current != nullptr; current = current->nextNode) {
             insertAtTail(current->val);
         }
@@ -64,15 +193,33 @@ public:
         return *this;
     }
 
+    // move constructor - takes over the nodes of other, which is left empty (using the same pool)
+    LinkedList(LinkedList&& other) noexcept : head(other.head), tail(other.tail), pool(other.pool), nodeCount(other.nodeCount) {
+        other.head = nullptr;
+        other.tail = nullptr;
+        other.nodeCount = 0;
+    }
+
+    // move assignment operator
+    // our old nodes end up in tmp, which frees them (to our pool) when it goes out of scope
+    LinkedList& operator=(LinkedList&& other) noexcept {
+        if (this != &other) {
+            LinkedList tmp(std::move(other));
+            swap(tmp);
+        }
+        return *this;
+    }
+
 
 
     // this function creates a linked list with the values provided by the vector argument
     void createList(const std::vector<T>& values) {
         head = nullptr;
         tail = nullptr;
+        nodeCount = 0;
 
         for (const T& value : values) {
-            ListNode<T>* newNode = new ListNode<T>(value, nullptr);
+            ListNode<T>* newNode = createNode(nullptr, value);
 
             // if the list is empty, this created new node becomes both the head and the tail
             // as it is the only node in the list
@@ -89,59 +236,86 @@ public:
     }
 
     // this function returns the number of nodes in the linked list
+    // the count is kept up to date on every insertion and deletion, so this is O(1)
     int countNodes() const {
-        int nodeCount = 0;
-        ListNode<T>* ptr = head;
-        while (ptr != nullptr) {
-            nodeCount++;
-            ptr = ptr->nextNode;
-        }
         return nodeCount;
     }
 
     // this function inserts a node at the head of the linked list
-    void insertAtHead(const T v) {
-        // if the list is empty, we set both head and tail to be this new node
+    void insertAtHead(const T& v) {
+        emplaceAtHead(v);
+    }
+
+    void insertAtHead(T&& v) {
+        emplaceAtHead(std::move(v));
+    }
+
+    // this function constructs a value in place, in a new node at the head of the linked list
+    // returns a reference to the new value
+    template<typename... Args>
+    T& emplaceAtHead(Args&&... args) {
+        // the new node has next = head (nullptr if the list is empty), then we update head
+        ListNode<T>* tmp = createNode(head, std::forward<Args>(args)...);
         if (head == nullptr) {
-            ListNode<T>* tmp = new ListNode<T>(v, nullptr);
-            this->head = tmp;
+            // if the list was empty, the new node is also the tail
             this->tail = tmp;
-            return;
         }
-
-        // otherwise we add a new node, which has next = head, then we update head
-        ListNode<T>* tmp = new ListNode<T>(v, head);
         this->head = tmp;
+        return tmp->val;
     }
 
     // this function inserts a node at the tail of the linked list
-    void insertAtTail(const T v) {
-        // if the list is empty, we set both head and tail to be this new node
+    void insertAtTail(const T& v) {
+        emplaceAtTail(v);
+    }
+
+    void insertAtTail(T&& v) {
+        emplaceAtTail(std::move(v));
+    }
+
+    // this function constructs a value in place, in a new node at the tail of the linked list
+    // returns a reference to the new value
+    template<typename... Args>
+    T& emplaceAtTail(Args&&... args) {
+        // the new node has next = nullptr, as it is the tail
+        ListNode<T>* tmp = createNode(nullptr, std::forward<Args>(args)...);
         if (head == nullptr) {
-            ListNode<T>* tmp = new ListNode<T>(v, nullptr);
+            // if the list is empty, we set both head and tail to be this new node
             this->head = tmp;
             this->tail = tmp;
-            return;
+            return tmp->val;
         }
 
-        // otherwise we add a new node, which has next = nullptr, as it as the tail
-        // we link the new node to the previous tail, then we update tail
-        ListNode<T>* tmp = new ListNode<T>(v, nullptr);
+        // otherwise we link the new node to the previous tail, then we update tail
         this->tail->nextNode = tmp;
         this->tail = tmp;
+        return tmp->val;
     }
 
     // this function inserts a node at a specified index of the linked list
     // @throws invalid argument if index is negative
     // @throws out_of_range error if provided index > number of nodes in list
-    void insertAtIndex(const T v, const int idx) {
+    void insertAtIndex(const T& v, const int idx) {
+        emplaceAtIndex(idx, v);
+    }
+
+    void insertAtIndex(T&& v, const int idx) {
+        emplaceAtIndex(idx, std::move(v));
+    }
+
+    // this function constructs a value in place, in a new node at a specified index of the linked list
+    // returns a reference to the new value
+    // @throws invalid argument if index is negative
+    // @throws out_of_range error if provided index > number of nodes in list
+    template<typename... Args>
+    T& emplaceAtIndex(const int idx, Args&&... args) {
         // check provided index is positive
         if (idx < 0) {
             throw std::invalid_argument("Negative index not allowed.");
         }
         // check provided index is not bigger than length of the list
         // list is 0-indexed, so we use >=
-        if (idx > this->countNodes()) {
+        if (idx > nodeCount) {
             throw std::out_of_range("index is out of range for insertion.");
         }
 
@@ -149,13 +323,12 @@ public:
 
         // if insertion at idx 0, special case insert at head
         if (idx == 0) {
-            insertAtHead(v);
-            return;
+            return emplaceAtHead(std::forward<Args>(args)...);
         }
 
         // if insertion is at the tail, special case
-        if (idx == countNodes()) {
-            insertAtTail(v);
+        if (idx == nodeCount) {
+            return emplaceAtTail(std::forward<Args>(args)...);
         }
 
         // traverse to the node at idx
@@ -164,13 +337,125 @@ public:
             current = current->nextNode;
         }
 
-        ListNode<T>* tmp = new ListNode<T>(v, current->nextNode);
+        ListNode<T>* tmp = createNode(current->nextNode, std::forward<Args>(args)...);
         current->nextNode = tmp;
-        
-        // if idx was the last element, update tail
-        if (current == tail) {
-            tail = tmp;
+        return tmp->val;
+    }
+
+    // this function removes the head node and returns its value, moved out of the node
+    // @throws out_of_range error if the list is empty
+    T popHead() {
+        if (head == nullptr) {
+            throw std::out_of_range("Called popHead on an empty list.");
+        }
+        ListNode<T>* tmp = head;
+        T value = std::move(tmp->val);
+        head = head->nextNode;
+        if (head == nullptr) {
+            tail = nullptr;
+        }
+        destroyNode(tmp);
+        return value;
+    }
+
+    // this function moves all nodes of other into this list, so that they start at index idx
+    // nodes are relinked, not copied: O(1) at the head and the tail, otherwise O(idx) to walk to the position.
+    // if other allocates from a different pool, its values are moved into new nodes from our pool instead (O(n))
+    // other is left empty
+    // @throws invalid argument if index is negative, or other is this list
+    // @throws out_of_range error if provided index > number of nodes in list
+    void splice(const int idx, LinkedList&& other) {
+        if (idx < 0) {
+            throw std::invalid_argument("Negative index not allowed.");
+        }
+        if (idx > nodeCount) {
+            throw std::out_of_range("index is out of range for splice.");
+        }
+        if (&other == this) {
+            throw std::invalid_argument("Cannot splice a list into itself.");
+        }
+
+        // a node has to be freed to the pool it came from, so nodes can only change lists within a pool
+        if (other.pool != pool) {
+            LinkedList adopted(pool);
+            while (other.head != nullptr) {
+                adopted.emplaceAtTail(other.popHead());
+            }
+            splice(idx, std::move(adopted));
+            return;
+        }
+        if (other.head == nullptr) {
+            return;
         }
+
+        if (idx == 0) {
+            other.tail->nextNode = head;
+            head = other.head;
+            if (tail == nullptr) {
+                tail = other.tail;
+            }
+        }
+        else {
+            // the node after which other is linked in
+            ListNode<T>* before = tail;
+            if (idx < nodeCount) {
+                before = head;
+                for (int i = 0; i < idx - 1; ++i) {
+                    before = before->nextNode;
+                }
+            }
+            other.tail->nextNode = before->nextNode;
+            before->nextNode = other.head;
+            if (before == tail) {
+                tail = other.tail;
+            }
+        }
+
+        nodeCount += other.nodeCount;
+        other.head = nullptr;
+        other.tail = nullptr;
+        other.nodeCount = 0;
+    }
+
+    // this function moves all nodes of other to the end of this list in O(1) (see splice), leaving other empty
+    void append(LinkedList&& other) {
+        splice(nodeCount, std::move(other));
+    }
+
+    // this function detaches the nodes from index idx onwards, and returns them as a new list (using the same pool)
+    // nothing is copied; it takes O(idx) to walk to the split point
+    // @throws invalid argument if index is negative
+    // @throws out_of_range error if provided index > number of nodes in list
+    LinkedList split_at(const int idx) {
+        if (idx < 0) {
+            throw std::invalid_argument("Negative index not allowed.");
+        }
+        if (idx > nodeCount) {
+            throw std::out_of_range("index is out of range for split.");
+        }
+
+        LinkedList suffix(pool);
+        if (idx == nodeCount) {
+            return suffix;
+        }
+        if (idx == 0) {
+            swap(suffix);
+            return suffix;
+        }
+
+        // the last node which stays in this list
+        ListNode<T>* last = head;
+        for (int i = 0; i < idx - 1; ++i) {
+            last = last->nextNode;
+        }
+        suffix.head = last->nextNode;
+        suffix.tail = tail;
+        suffix.nodeCount = nodeCount - idx;
+
+        last->nextNode = nullptr;
+        tail = last;
+        nodeCount = idx;
+        return suffix;
     }
 
     // this function returns true if the linked list contains a node with the value v
@@ -213,7 +498,7 @@ public:
                 tail = nullptr;
             }
 
-            delete tmp; // free the memory of the deleted node
+            destroyNode(tmp); // free the memory of the deleted node
             return true; // return true as a deletion did take place
         }
 
@@ -228,7 +513,7 @@ public:
                     tail = current;
                 }
 
-                delete tmp; // free the memory of the deleted node
+                destroyNode(tmp); // free the memory of the deleted node
                 return true;
             }
             current = current->nextNode;
@@ -277,6 +562,53 @@ public:
         this->head = previous;     // the new head is the last node pointed to by previous (as current is null at end of while loop)
     }
 
+    // this function sorts the list in ascending order (using operator<) by relinking nodes,
+    // without allocating: bottom-up merge sort over the natural runs already present in the list,
+    // so an already sorted list takes a single O(n) traversal and the worst case is O(n log n).
+    // the sort is stable.
+    void sort() {
+        if (head == nullptr) {
+            return;
+        }
+
+        // runs are merged like a binary counter: pending[i] is either empty or a sorted chain made of 2^i runs.
+        // merges happen while the runs involved are still recent (hence in cache), instead of in passes over
+        // the whole list. the slots live on the stack, so nothing is allocated
+        ListNode<T>* pending[64] = {};
+        ListNode<T>* pendingEnd[64];
+
+        ListNode<T>* rest = head;
+        while (rest != nullptr) {
+            ListNode<T>* run = rest;
+            ListNode<T>* runLast = runEnd(run);
+            rest = runLast->nextNode;
+            runLast->nextNode = nullptr;
+
+            int i = 0;
+            for (; pending[i] != nullptr; i++) {
+                runLast = mergeRuns(pending[i], pendingEnd[i], run, runLast, &run);
+                pending[i] = nullptr;
+            }
+            pending[i] = run;
+            pendingEnd[i] = runLast;
+        }
+
+        // fold the remaining slots together; a higher slot holds earlier nodes, so it goes on the left
+        head = nullptr;
+        for (int i = 0; i < 64; i++) {
+            if (pending[i] == nullptr) {
+                continue;
+            }
+            if (head == nullptr) {
+                head = pending[i];
+                tail = pendingEnd[i];
+            }
+            else {
+                tail = mergeRuns(pending[i], pendingEnd[i], head, tail, &head);
+            }
+        }
+    }
+
     // this function prints the linked list to the terminal
     // with the mem addr and the value of each list node
     void print() const {
@@ -296,5 +628,124 @@ public:
     void swap(LinkedList& other) noexcept {
         std::swap(head, other.head);
         std::swap(tail, other.tail);
+        std::swap(pool, other.pool); // the nodes stay with the pool they came from
+        std::swap(nodeCount, other.nodeCount);
+    }
+};
+
+
+// this function times a queue-like churn on a list: n nodes, then `operations` rounds of
+// inserting at the tail and deleting the head, followed by full scans of the churned list
+void benchmarkChurn(const std::string& name, LinkedList<int>& list, int n, int operations) {
+    for (int i = 0; i < n; i++) {
+        list.insertAtTail(i);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = n; i < n + operations; i++) {
+        list.insertAtTail(i);
+        list.deleteFirstInstance(i - n); // always the head
+    }
+    auto churned = std::chrono::steady_clock::now();
+    int found = 0;
+    for (int r = 0; r < 10; r++) {
+        found += list.countInstances(n + operations - 1);
     }
-};
\ No newline at end of file
+    auto scanned = std::chrono::steady_clock::now();
+
+    std::cout << name << ": churn " << std::chrono::duration<double, std::nano>(churned - start).count() / operations
+              << " ns/op, scan " << std::chrono::duration<double, std::nano>(scanned - churned).count() / (10.0 * n)
+              << " ns/node (found " << found << ")" << std::endl;
+}
+
+// this function merges `parts` lists of n values each (like per-thread results) into one,
+// either by moving every value into a new node with insertAtTail or by relinking the lists with append
+void benchmarkMerge(int parts, int n) {
+    auto makeResults = [parts, n]() {
+        std::vector<LinkedList<int>> results(parts);
+        for (LinkedList<int>& part : results) {
+            for (int i = 0; i < n; i++) {
+                part.insertAtTail(i);
+            }
+        }
+        return results;
+    };
+
+    std::vector<LinkedList<int>> results = makeResults();
+    auto start = std::chrono::steady_clock::now();
+    LinkedList<int> copied;
+    for (LinkedList<int>& part : results) {
+        while (part.countNodes() > 0) {
+            copied.insertAtTail(part.popHead());
+        }
+    }
+    auto copiedAll = std::chrono::steady_clock::now();
+
+    results = makeResults();
+    auto relinkStart = std::chrono::steady_clock::now();
+    LinkedList<int> merged;
+    for (LinkedList<int>& part : results) {
+        merged.append(std::move(part));
+    }
+    auto mergedAll = std::chrono::steady_clock::now();
+
+    std::cout << "merge " << parts << " x " << n << " nodes: per element " << std::chrono::duration<double, std::milli>(copiedAll - start).count()
+              << " ms, append " << std::chrono::duration<double, std::micro>(mergedAll - relinkStart).count()
+              << " us (" << merged.countNodes() << " nodes)" << std::endl;
+}
+
+// this function times sort() on n random values and on n values that are already sorted
+void benchmarkSort(int n) {
+    std::mt19937 rng(42);
+    std::vector<int> values(n);
+    for (int& v : values) {
+        v = static_cast<int>(rng() % 1000000);
+    }
+
+    LinkedList<int> shuffled(values);
+    auto start = std::chrono::steady_clock::now();
+    shuffled.sort();
+    auto sortedRandom = std::chrono::steady_clock::now();
+
+    std::sort(values.begin(), values.end());
+    LinkedList<int> ascending(values);
+    auto built = std::chrono::steady_clock::now();
+    ascending.sort(); // a single run: one traversal, no merges
+    auto sortedAscending = std::chrono::steady_clock::now();
+
+    std::cout << "sort " << n << " random ints: " << std::chrono::duration<double, std::milli>(sortedRandom - start).count()
+              << " ms, already sorted: " << std::chrono::duration<double, std::milli>(sortedAscending - built).count()
+              << " ms" << std::endl;
+}
+
+int main() {
+    NodePool<ListNode<std::string>> stringPool;
+    LinkedList<std::string> names(&stringPool);
+    names.insertAtTail("b");
+    names.insertAtHead("a");
+    names.insertAtTail("c");
+    names.deleteFirstInstance("b");
+    names.insertAtTail("d"); // reuses the slot freed by "b"
+    names.insertAtTail("b");
+    names.emplaceAtIndex(1, 3, 'x'); // constructs std::string(3, 'x') inside the node
+    names.sort();
+    LinkedList<std::string> moved = std::move(names); // takes over the nodes, nothing is copied
+    std::cout << "popHead() = " << moved.popHead() << " | names.countNodes() = " << names.countNodes() << std::endl;
+    moved.print();
+
+    LinkedList<std::string> suffix = moved.split_at(2); // [b, c] and [d, xxx]
+    moved.splice(0, std::move(suffix));                 // [d, xxx, b, c]
+    moved.print();
+
+    const int N = 100000;
+    const int OPERATIONS = 2000000;
+    LinkedList<int> plain;
+    benchmarkChurn("new/delete", plain, N, OPERATIONS);
+
+    NodePool<ListNode<int>> pool;
+    LinkedList<int> pooled(&pool);
+    benchmarkChurn("node pool ", pooled, N, OPERATIONS);
+
+    benchmarkSort(2000000);
+    benchmarkMerge(8, 1000000);
+}
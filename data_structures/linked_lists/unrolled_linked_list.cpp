@@ -0,0 +1,385 @@
+/**
+ * Unrolled linked list: a singly linked list whose nodes each hold a small array of elements,
+ * sized to about two cache lines. Scans touch one node per block of elements instead of one per
+ * element, so they run close to array speed, while inserting in the middle only shifts the
+ * elements of a single node (splitting it when full).
+ */
+
+#include <iostream>
+#include <string>
+#include <sstream>
+#include <vector>
+#include <list>
+#include <stdexcept>
+#include <utility>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <new>
+
+
+template<typename T>
+class UnrolledLinkedList {
+public:
+    static const size_t NODE_BYTES = 128;
+    // as many elements as fit in NODE_BYTES alongside the node header, but at least 2 so nodes can split
+    static const size_t NODE_CAPACITY = (NODE_BYTES - 2 * sizeof(void*)) / sizeof(T) >= 2
+                                        ? (NODE_BYTES - 2 * sizeof(void*)) / sizeof(T) : 2;
+
+private:
+    struct Node {
+        size_t count;
+        Node* nextNode;
+        alignas(T) unsigned char storage[NODE_CAPACITY * sizeof(T)]; // only [0, count) is constructed
+
+        Node() : count(0), nextNode(nullptr) {}
+        T* vals() { return reinterpret_cast<T*>(storage); }
+        const T* vals() const { return reinterpret_cast<const T*>(storage); }
+    };
+
+    Node* head;
+    Node* tail;
+    size_t m_size;
+
+    // this function links a new empty node after prev (or at the head if prev is null)
+    Node* insertNodeAfter(Node* prev) {
+        Node* node = new Node();
+        if (prev == nullptr) {
+            node->nextNode = head;
+            head = node;
+        }
+        else {
+            node->nextNode = prev->nextNode;
+            prev->nextNode = node;
+        }
+        if (node->nextNode == nullptr) { tail = node; }
+        return node;
+    }
+
+    // this function unlinks and frees an empty node, given its predecessor (null for the head)
+    void removeNode(Node* prev, Node* node) {
+        if (prev == nullptr) { head = node->nextNode; }
+        else { prev->nextNode = node->nextNode; }
+        if (tail == node) { tail = prev; }
+        delete node;
+    }
+
+    // this function inserts v at position pos of a node which is not full,
+    // shifting the later elements of the node up by one
+    static void insertInNode(Node* node, size_t pos, const T& v) {
+        T* vals = node->vals();
+        if (pos == node->count) {
+            new (vals + pos) T(v);
+        }
+        else {
+            new (vals + node->count) T(std::move(vals[node->count - 1]));
+            std::move_backward(vals + pos, vals + node->count - 1, vals + node->count);
+            vals[pos] = v;
+        }
+        node->count++;
+    }
+
+    // this function removes the element at position pos of a node, shifting the later elements down
+    static void eraseInNode(Node* node, size_t pos) {
+        T* vals = node->vals();
+        std::move(vals + pos + 1, vals + node->count, vals + pos);
+        node->count--;
+        vals[node->count].~T();
+    }
+
+    // this function moves the upper half of a full node into a new node after it
+    void splitNode(Node* node) {
+        Node* upper = insertNodeAfter(node);
+        size_t keep = node->count / 2;
+        T* from = node->vals();
+        for (size_t i = keep; i < node->count; i++) {
+            new (upper->vals() + (i - keep)) T(std::move(from[i]));
+            from[i].~T();
+        }
+        upper->count = node->count - keep;
+        node->count = keep;
+    }
+
+    // this function moves the elements of node->nextNode into node while they all fit,
+    // so that nodes do not stay half empty after deletions
+    void mergeWithNext(Node* node) {
+        Node* next = node->nextNode;
+        if (next == nullptr || node->count + next->count > NODE_CAPACITY) { return; }
+        for (size_t i = 0; i < next->count; i++) {
+            new (node->vals() + node->count + i) T(std::move(next->vals()[i]));
+            next->vals()[i].~T();
+        }
+        node->count += next->count;
+        next->count = 0;
+        removeNode(node, next);
+    }
+
+    void clear() {
+        Node* current = head;
+        while (current != nullptr) {
+            Node* tmp = current->nextNode;
+            std::destroy_n(current->vals(), current->count);
+            delete current;
+            current = tmp;
+        }
+        head = nullptr;
+        tail = nullptr;
+        m_size = 0;
+    }
+
+public:
+    UnrolledLinkedList() : head(nullptr), tail(nullptr), m_size(0) {}
+
+    UnrolledLinkedList(const std::vector<T>& values) : head(nullptr), tail(nullptr), m_size(0) {
+        for (const T& value : values) {
+            insertAtTail(value);
+        }
+    }
+
+    // destructor should deallocate all memory used by the list
+    ~UnrolledLinkedList() {
+        clear();
+    }
+
+    // copy constructor (deep copy)
+    UnrolledLinkedList(const UnrolledLinkedList& other) : head(nullptr), tail(nullptr), m_size(0) {
+        for (const Node* node = other.head; node != nullptr; node = node->nextNode) {
+            for (size_t i = 0; i < node->count; i++) {
+                insertAtTail(node->vals()[i]);
+            }
+        }
+    }
+
+    // assignment operator
+    UnrolledLinkedList& operator=(const UnrolledLinkedList& other) {
+        if (this != &other) {
+            UnrolledLinkedList tmp(other);
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    // this function returns the number of elements in the list (O(1))
+    int countNodes() const {
+        return static_cast<int>(m_size);
+    }
+
+    // this function inserts an element at the head of the list
+    void insertAtHead(const T v) {
+        if (head == nullptr || head->count == NODE_CAPACITY) {
+            insertNodeAfter(nullptr);
+        }
+        insertInNode(head, 0, v);
+        m_size++;
+    }
+
+    // this function inserts an element at the tail of the list
+    void insertAtTail(const T v) {
+        if (tail == nullptr || tail->count == NODE_CAPACITY) {
+            insertNodeAfter(tail);
+        }
+        insertInNode(tail, tail->count, v);
+        m_size++;
+    }
+
+    // this function inserts an element at a specified index of the list
+    // only the node holding that index is touched (and split if it is full)
+    // @throws invalid argument if index is negative
+    // @throws out_of_range error if provided index > number of elements in list
+    void insertAtIndex(const T v, const int idx) {
+        if (idx < 0) {
+            throw std::invalid_argument("Negative index not allowed.");
+        }
+        if (static_cast<size_t>(idx) > m_size) {
+            throw std::out_of_range("index is out of range for insertion.");
+        }
+        if (static_cast<size_t>(idx) == m_size) {
+            insertAtTail(v);
+            return;
+        }
+
+        // find the node holding position idx
+        size_t pos = idx;
+        Node* node = head;
+        while (pos >= node->count) {
+            pos -= node->count;
+            node = node->nextNode;
+        }
+
+        if (node->count == NODE_CAPACITY) {
+            splitNode(node);
+            if (pos > node->count) {
+                pos -= node->count;
+                node = node->nextNode;
+            }
+        }
+        insertInNode(node, pos, v);
+        m_size++;
+    }
+
+    // this function returns true if the list contains the value v, false otherwise
+    bool contains(const T v) const {
+        for (const Node* node = head; node != nullptr; node = node->nextNode) {
+            const T* vals = node->vals();
+            for (size_t i = 0; i < node->count; i++) {
+                if (vals[i] == v) { return true; }
+            }
+        }
+        return false;
+    }
+
+    // this function deletes the first instance of a value in the list
+    // returns true if a deletion occurred, else false
+    bool deleteFirstInstance(const T v) {
+        Node* prev = nullptr;
+        for (Node* node = head; node != nullptr; prev = node, node = node->nextNode) {
+            for (size_t i = 0; i < node->count; i++) {
+                if (node->vals()[i] == v) {
+                    eraseInNode(node, i);
+                    m_size--;
+                    if (node->count == 0) {
+                        removeNode(prev, node);
+                    }
+                    else if (node->count < NODE_CAPACITY / 2) {
+                        mergeWithNext(node);
+                    }
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    // this function deletes all instances of a value in the list
+    // each node is compacted in place, then empty nodes are freed and neighbours merged,
+    // all in one traversal
+    void deleteAllInstances(const T v) {
+        Node* prev = nullptr;
+        Node* node = head;
+        while (node != nullptr) {
+            T* vals = node->vals();
+            size_t write = 0;
+            for (size_t read = 0; read < node->count; read++) {
+                if (vals[read] == v) { continue; }
+                if (write != read) { vals[write] = std::move(vals[read]); }
+                write++;
+            }
+            std::destroy_n(vals + write, node->count - write);
+            m_size -= node->count - write;
+            node->count = write;
+
+            if (prev != nullptr && prev->count + node->count <= NODE_CAPACITY) {
+                mergeWithNext(prev); // node is absorbed into prev (or freed, if empty)
+                node = prev->nextNode;
+                continue;
+            }
+            if (node->count == 0) {
+                Node* next = node->nextNode;
+                removeNode(prev, node);
+                node = next;
+                continue;
+            }
+            prev = node;
+            node = node->nextNode;
+        }
+    }
+
+    // this function returns the number of elements with the specified value
+    int countInstances(const T v) const {
+        int counter = 0;
+        for (const Node* node = head; node != nullptr; node = node->nextNode) {
+            const T* vals = node->vals();
+            for (size_t i = 0; i < node->count; i++) {
+                counter += vals[i] == v;
+            }
+        }
+        return counter;
+    }
+
+    // this function reverses the order of the list in-place:
+    // the chain of nodes is reversed, and so is the array inside each node
+    void reverse() {
+        Node* previous = nullptr;
+        Node* current = head;
+        while (current != nullptr) {
+            Node* tmp = current->nextNode;
+            current->nextNode = previous;
+            std::reverse(current->vals(), current->vals() + current->count);
+            previous = current;
+            current = tmp;
+        }
+        tail = head;
+        head = previous;
+    }
+
+    // this function prints the list to the terminal, one node (block of elements) per line
+    void print() const {
+        if (head == nullptr) {
+            std::cout << "Empty list" << std::endl;
+            return;
+        }
+        for (const Node* node = head; node != nullptr; node = node->nextNode) {
+            std::ostringstream oss;
+            oss << "[UnrolledNode | addr: " << node << " vals:";
+            for (size_t i = 0; i < node->count; i++) {
+                oss << " " << node->vals()[i];
+            }
+            oss << "]\n";
+            std::cout << oss.str();
+        }
+    }
+
+    // helper function to swap the internals of two UnrolledLinkedList objects
+    void swap(UnrolledLinkedList& other) noexcept {
+        std::swap(head, other.head);
+        std::swap(tail, other.tail);
+        std::swap(m_size, other.m_size);
+    }
+};
+
+
+// this function times `repeats` full scans (countInstances / std::count) of a container
+template<typename Fn>
+double timeScans(Fn scan, int repeats) {
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < repeats; r++) {
+        scan();
+    }
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / repeats;
+}
+
+int main() {
+    UnrolledLinkedList<int> small({1, 2, 3, 4, 5});
+    small.insertAtIndex(42, 2);
+    small.insertAtHead(0);
+    small.deleteFirstInstance(4);
+    small.reverse();
+    small.print();
+
+    const int N = 4000000;
+    const int REPEATS = 10;
+    UnrolledLinkedList<int> unrolled;
+    std::list<int> nodes;
+    std::vector<int> array;
+    for (int i = 0; i < N; i++) {
+        unrolled.insertAtTail(i % 100);
+        nodes.push_back(i % 100);
+        array.push_back(i % 100);
+    }
+
+    int found = 0;
+    double tUnrolled = timeScans([&] { found += unrolled.countInstances(7); }, REPEATS);
+    double tList = timeScans([&] { found += static_cast<int>(std::count(nodes.begin(), nodes.end(), 7)); }, REPEATS);
+    double tArray = timeScans([&] { found += static_cast<int>(std::count(array.begin(), array.end(), 7)); }, REPEATS);
+    std::cout << "scan of " << N << " ints (node capacity " << UnrolledLinkedList<int>::NODE_CAPACITY << "): "
+              << "unrolled " << tUnrolled / N << " ns/elem, std::list " << tList / N
+              << " ns/elem, std::vector " << tArray / N << " ns/elem (found " << found << ")" << std::endl;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 1000; i++) {
+        unrolled.insertAtIndex(-1, N / 2);
+    }
+    std::cout << "insertAtIndex in the middle: "
+              << std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / 1000
+              << " us/insert (walk to the node + shift within it)" << std::endl;
+}
@@ -1,85 +1,227 @@
 /**
  * Deque (double-ended queue) implementation.
+ * Elements are stored in fixed-size blocks of contiguous memory, found through a central map of
+ * block pointers. Pushing or popping at either end only touches the end block (allocating or
+ * freeing a block now and then), element i is found with a shift and a mask, and the map itself
+ * only holds one pointer per block, so growing it moves no elements.
  */
 
 #include <iostream>
 #include <string>
 #include <sstream>
 #include <stdexcept>
+#include <utility>
+#include <algorithm>
+#include <memory>
+#include <cstring>
+#include <new>
 
 template<typename T>
-struct QueueNode {
+class Deque {
+private:
+    // elements per block: the largest power of two (at least 8) that fits in about 512 bytes
+    static constexpr size_t blockSizeFor(size_t bytes) {
+        size_t n = 8;
+        while (2 * n * sizeof(T) <= bytes) { n *= 2; }
+        return n;
+    }
 
-    T val;
-    QueueNode* next;
+    static constexpr size_t log2(size_t n) {
+        size_t shift = 0;
+        while ((size_t(1) << shift) < n) { shift++; }
+        return shift;
+    }
 
-    QueueNode() : val(), next(nullptr) {}
-    QueueNode(T val) : val(val), next(nullptr) {}
-    QueueNode(T val, QueueNode<T>* next) : val(val), next(next) {}
+    static constexpr size_t BLOCK_SIZE = blockSizeFor(512);
+    static constexpr size_t BLOCK_SHIFT = log2(BLOCK_SIZE);
+    static constexpr size_t BLOCK_MASK = BLOCK_SIZE - 1;
+    static constexpr size_t MIN_MAP_CAPACITY = 8;
 
-    // Explicit conversion operator to convert from QueueNode object to a string.
-    // Output of type [ListNode | addr: 0xffff val: {value}].
-    explicit operator std::string() const {
-        std::ostringstream oss;
-        oss << "[QueueNode | addr: " << this << " val: " << this->val << "]\n";
-        return oss.str();
+    // element i lives at position first + i of a virtual array spanning all map slots:
+    // in block (first + i) >> BLOCK_SHIFT, at offset (first + i) & BLOCK_MASK
+    T** map;            // map[b] is block b, or nullptr if no element lives in it
+    size_t mapCapacity;
+    size_t first;
+    size_t count;
+    T* spare;           // an emptied block kept for reuse, so a deque going back and forth over a block boundary does not allocate every time
+
+    T* slot(size_t v) const {
+        return map[v >> BLOCK_SHIFT] + (v & BLOCK_MASK);
     }
-};
 
+    T* allocateBlock() {
+        if (spare != nullptr) {
+            T* block = spare;
+            spare = nullptr;
+            return block;
+        }
+        return static_cast<T*>(::operator new(BLOCK_SIZE * sizeof(T)));
+    }
 
-template<typename T>
-class Deque {
-private: 
-    QueueNode<T>* head;
-    QueueNode<T>* tail;
+    // frees block b, which must hold no elements (keeping it as the spare if there is none)
+    void releaseBlock(size_t b) {
+        if (spare == nullptr) { spare = map[b]; }
+        else { ::operator delete(map[b]); }
+        map[b] = nullptr;
+    }
+
+    // centres the blocks in use in the map, so there is a free map slot at both ends,
+    // allocating a map twice as large if the blocks take up more than half of it.
+    // only block pointers move; the elements stay where they are
+    void reallocateMap() {
+        size_t firstBlock = first >> BLOCK_SHIFT;
+        size_t usedBlocks = count == 0 ? 0 : ((first + count - 1) >> BLOCK_SHIFT) - firstBlock + 1;
+        size_t newFirstBlock;
+        if (2 * (usedBlocks + 1) <= mapCapacity) {
+            newFirstBlock = (mapCapacity - usedBlocks) / 2;
+            std::memmove(map + newFirstBlock, map + firstBlock, usedBlocks * sizeof(T*));
+            std::fill(map, map + newFirstBlock, nullptr);
+            std::fill(map + newFirstBlock + usedBlocks, map + mapCapacity, nullptr);
+        }
+        else {
+            size_t newCapacity = std::max(MIN_MAP_CAPACITY, 2 * std::max(mapCapacity, usedBlocks + 1));
+            T** newMap = new T*[newCapacity]();
+            newFirstBlock = (newCapacity - usedBlocks) / 2;
+            std::copy(map + firstBlock, map + firstBlock + usedBlocks, newMap + newFirstBlock);
+            delete[] map;
+            map = newMap;
+            mapCapacity = newCapacity;
+        }
+        first = (newFirstBlock << BLOCK_SHIFT) | (first & BLOCK_MASK);
+    }
+
+    // calls fn(run, n) for every run of elements which are contiguous in memory, in order
+    template<typename Fn>
+    void forEachRun(Fn fn) const {
+        size_t i = 0;
+        while (i < count) {
+            size_t v = first + i;
+            size_t n = std::min(BLOCK_SIZE - (v & BLOCK_MASK), count - i);
+            fn(slot(v), n);
+            i += n;
+        }
+    }
+
+    void clear() {
+        forEachRun([](T* run, size_t n) { std::destroy_n(run, n); });
+        for (size_t b = 0; b < mapCapacity; b++) {
+            ::operator delete(map[b]);
+        }
+        ::operator delete(spare);
+        delete[] map;
+        map = nullptr;
+        mapCapacity = 0;
+        first = 0;
+        count = 0;
+        spare = nullptr;
+    }
 
 public:
-    Deque() : head(nullptr), tail(nullptr) {}
+    Deque() : map(nullptr), mapCapacity(0), first(0), count(0), spare(nullptr) {}
 
     ~Deque() {
-        while (!isEmpty()) {
-            popHead();
+        clear();
+    }
+
+    // copy constructor (deep copy)
+    Deque(const Deque& other) : Deque() {
+        other.forEach([this](const T& val) { insertAtTail(val); });
+    }
+
+    // assignment operator
+    Deque& operator=(const Deque& other) {
+        if (this != &other) {
+            Deque tmp(other);
+            swap(tmp);
         }
+        return *this;
+    }
+
+    // move constructor: takes over the blocks of other, which is left empty
+    Deque(Deque&& other) noexcept : Deque() {
+        swap(other);
+    }
+
+    // move assignment operator
+    Deque& operator=(Deque&& other) noexcept {
+        if (this != &other) {
+            Deque tmp(std::move(other)); // tmp frees our old blocks
+            swap(tmp);
+        }
+        return *this;
     }
 
     // returns true if the queue is empty
     bool isEmpty() const {
-        return head == nullptr;
+        return count == 0;
     }
 
-    // returns the number of elements in the queue
+    // returns the number of elements in the queue (O(1))
     int countElements() const {
-        int counter = 0;
-        const QueueNode<T>* curr = head;
-        while (curr != nullptr) {
-            counter++;
-            curr = curr->next;
-        }
-        return counter;
+        return static_cast<int>(count);
     }
 
     // inserts an element at the head of the queue
-    void insertAtHead(T val) {
-        if (head == nullptr) { // case that list is empty
-            head = new QueueNode<T>(val);
-            tail = head;
-            return;
+    void insertAtHead(const T& val) {
+        emplaceAtHead(val);
+    }
+
+    void insertAtHead(T&& val) {
+        emplaceAtHead(std::move(val));
+    }
+
+    // constructs an element in place at the head of the queue
+    // @returns a reference to the new element
+    template<typename... Args>
+    T& emplaceAtHead(Args&&... args) {
+        if (first == 0) {
+            reallocateMap();
+        }
+        size_t v = first - 1;
+        size_t b = v >> BLOCK_SHIFT;
+        bool newBlock = map[b] == nullptr;
+        if (newBlock) { map[b] = allocateBlock(); }
+        try {
+            new (slot(v)) T(std::forward<Args>(args)...);
         }
-        QueueNode<T>* old_head = head;
-        head = new QueueNode<T>(val);
-        head->next = old_head;
+        catch (...) {
+            if (newBlock) { releaseBlock(b); }
+            throw;
+        }
+        first = v;
+        count++;
+        return *slot(v);
     }
 
     // inserts an element at the tail of the queue
-    void insertAtTail(T val) {
-        if (head == nullptr) { // case that list is empty
-            head = new QueueNode<T>(val);
-            tail = head;
-            return;
+    void insertAtTail(const T& val) {
+        emplaceAtTail(val);
+    }
+
+    void insertAtTail(T&& val) {
+        emplaceAtTail(std::move(val));
+    }
+
+    // constructs an element in place at the tail of the queue
+    // @returns a reference to the new element
+    template<typename... Args>
+    T& emplaceAtTail(Args&&... args) {
+        if (((first + count) >> BLOCK_SHIFT) >= mapCapacity) {
+            reallocateMap();
         }
-        QueueNode<T>* newTail = new QueueNode<T>(val);
-        tail->next = newTail;
-        tail = tail->next;
+        size_t v = first + count;
+        size_t b = v >> BLOCK_SHIFT;
+        bool newBlock = map[b] == nullptr;
+        if (newBlock) { map[b] = allocateBlock(); }
+        try {
+            new (slot(v)) T(std::forward<Args>(args)...);
+        }
+        catch (...) {
+            if (newBlock) { releaseBlock(b); }
+            throw;
+        }
+        count++;
+        return *slot(v);
     }
 
     // gets the first element of the queue
@@ -87,7 +229,7 @@ public:
     T getHead() const {
         if (isEmpty()) { throw std::runtime_error("Attempted to getHead of empty queue"); }
 
-        return head->val;
+        return *slot(first);
     }
 
     // gets the last element of the queue
@@ -95,7 +237,24 @@ public:
     T getTail() const {
         if (isEmpty()) { throw std::runtime_error("Attempted to getTail of empty queue"); }
 
-        return tail->val;
+        return *slot(first + count - 1);
+    }
+
+    // returns the element at index idx (0 = head) in O(1), without bounds checking
+    T& operator[](size_t idx) {
+        return *slot(first + idx);
+    }
+
+    const T& operator[](size_t idx) const {
+        return *slot(first + idx);
+    }
+
+    // returns the element at index idx (0 = head) in O(1)
+    // @throws out_of_range error if idx >= number of elements
+    T& at(size_t idx) {
+        if (idx >= count) { throw std::out_of_range("Index is out of range."); }
+
+        return *slot(first + idx);
     }
 
     // removes the element at the head of the queue
@@ -103,36 +262,79 @@ public:
     void popHead() {
         if (isEmpty()) { throw std::runtime_error("Attempted to popHead of empty queue"); }
 
-        QueueNode<T>* oldHead = head;
-        head = head->next;
-        delete oldHead; // free the memory of the popped node
-
-        if (head == nullptr) { // if the queue became empty
-            tail = nullptr; // ensure tail does not point to the now-deleted node
+        size_t v = first;
+        slot(v)->~T();
+        first++;
+        count--;
+        if (count == 0 || (first & BLOCK_MASK) == 0) { // the block of the old head is now empty
+            releaseBlock(v >> BLOCK_SHIFT);
         }
     }
 
-    // removes the element at the tail of the queue
+    // removes the element at the head of the queue, moving its value into out
+    // @throws runtime error if queue is empty when called
+    void popHead(T& out) {
+        if (isEmpty()) { throw std::runtime_error("Attempted to popHead of empty queue"); }
+
+        out = std::move(*slot(first));
+        popHead();
+    }
+
+    // removes the element at the tail of the queue in O(1)
     // @throws runtime error if queue is empty when called
     void popTail() {
         if (isEmpty()) { throw std::runtime_error("Attempted to popTail of empty queue"); }
 
-        if (head == tail) { // if there is only one element (special case)
-            delete head;
-            head = tail = nullptr;
-            return;
-        }
-        
-        QueueNode<T>* tailPtr = head;
-        while (tailPtr->next != tail) {
-            tailPtr = tailPtr->next;
+        size_t v = first + count - 1;
+        slot(v)->~T();
+        count--;
+        if (count == 0 || (v & BLOCK_MASK) == 0) { // the block of the old tail is now empty
+            releaseBlock(v >> BLOCK_SHIFT);
         }
+    }
 
-        delete tail; // free the memory of the (old) tail 
+    // removes the element at the tail of the queue, moving its value into out
+    // @throws runtime error if queue is empty when called
+    void popTail(T& out) {
+        if (isEmpty()) { throw std::runtime_error("Attempted to popTail of empty queue"); }
 
-        tail = tailPtr; // update the tail
-        tail->next = nullptr; // ensure the tail points to null
+        out = std::move(*slot(first + count - 1));
+        popTail();
     }
 
-};
+    // calls fn(element) for every element from head to tail, walking each block as a plain array
+    template<typename Fn>
+    void forEach(Fn fn) {
+        forEachRun([&fn](T* run, size_t n) {
+            for (size_t i = 0; i < n; i++) { fn(run[i]); }
+        });
+    }
 
+    template<typename Fn>
+    void forEach(Fn fn) const {
+        forEachRun([&fn](const T* run, size_t n) {
+            for (size_t i = 0; i < n; i++) { fn(run[i]); }
+        });
+    }
+
+    void print() const {
+        std::cout << "Deque{\n";
+        for (size_t i = 0; i < count; i++) {
+            size_t v = first + i;
+            std::ostringstream oss;
+            oss << "    [DequeSlot | block: " << (v >> BLOCK_SHIFT) << " offset: " << (v & BLOCK_MASK) << " val: " << *slot(v) << "]\n";
+            std::cout << oss.str();
+        }
+        std::cout << "}" << std::endl;
+    }
+
+    // helper function to swap the contents of two deques
+    void swap(Deque& other) noexcept {
+        std::swap(map, other.map);
+        std::swap(mapCapacity, other.mapCapacity);
+        std::swap(first, other.first);
+        std::swap(count, other.count);
+        std::swap(spare, other.spare);
+    }
+
+};
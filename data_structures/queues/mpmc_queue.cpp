@@ -0,0 +1,395 @@
+/**
+ * A bounded queue for any number of producer and consumer threads, with no global lock.
+ * Every slot of the power-of-two ring carries a sequence number saying which lap of the ring it is
+ * ready for: a producer claims position pos only when its slot's sequence is pos (the slot is free for
+ * this lap), and a consumer only when it is pos + 1 (the slot holds the element written at pos).
+ * A thread claims a position with one compare-exchange on the shared enqueue (or dequeue) counter
+ * and then works on its slot alone. Counters never wrap in practice and a stale slot has the
+ * sequence of an earlier lap, so a late compare-exchange cannot mistake it for a free slot (no ABA).
+ */
+
+#include <iostream>
+#include <vector>
+#include <queue>
+#include <string>
+#include <utility>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <new>
+#include <cstdint>
+#include <type_traits>
+#include <exception>
+#include <climits>
+#include <optional>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+
+// How the blocking enqueue / dequeue wait while the queue is full / empty
+enum class WaitStrategy {
+    Spin,  // busy-wait with a CPU pause hint; lowest latency, but only with a core per waiting thread
+    Yield, // spin briefly, then yield the CPU between attempts
+    Futex  // spin briefly, then sleep until another thread makes progress (Linux; Yield elsewhere)
+};
+
+
+template<typename T>
+class MpmcQueue {
+private:
+    // Elements are moved into and out of their slots after the position has been claimed, when it can
+    // no longer be given back.
+    static_assert(std::is_nothrow_move_constructible<T>::value, "MpmcQueue needs a nothrow move constructor");
+
+    static const size_t CACHE_LINE = 64;
+    static const unsigned SPINS_BEFORE_WAITING = 64;
+
+    struct Cell {
+        std::atomic<size_t> sequence;
+        alignas(T) unsigned char storage[sizeof(T)];
+
+        T* value() { return reinterpret_cast<T*>(storage); }
+    };
+
+    // A futex word which is bumped when waiting threads may be able to make progress, and a flag saying
+    // someone may be asleep on it. The first notifier to see the flag clears it and wakes every sleeper,
+    // so later notifiers make no syscall until a thread goes back to sleep.
+    struct alignas(CACHE_LINE) WaitWord {
+        std::atomic<uint32_t> epoch;
+        std::atomic<uint32_t> sleeping;
+    };
+
+    Cell* const m_cells;
+    const size_t m_mask;
+    const WaitStrategy m_wait;
+    alignas(CACHE_LINE) std::atomic<size_t> m_enqueue_pos;
+    alignas(CACHE_LINE) std::atomic<size_t> m_dequeue_pos;
+    WaitWord m_items; // consumers wait here while the queue is empty
+    WaitWord m_slots; // producers wait here while the queue is full
+
+    static size_t round_up_to_power_of_two(size_t n) {
+        size_t capacity = 2; // a single slot could not tell "written this lap" from "free next lap"
+        while (capacity < n) { capacity <<= 1; }
+        return capacity;
+    }
+
+#ifdef __linux__
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex words must be plain 32-bit integers");
+
+    static void futex_wait(std::atomic<uint32_t>& word, uint32_t expected) {
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+    }
+
+    static void futex_wake(std::atomic<uint32_t>& word) {
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&word), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+    }
+#endif
+
+    // Called after an operation that may let a thread waiting on word proceed.
+    void notify(WaitWord& word) {
+#ifdef __linux__
+        if (m_wait != WaitStrategy::Futex) { return; }
+        // Orders the caller's publish before reading the flag; pairs with the fence in wait_for.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (word.sleeping.load(std::memory_order_relaxed) != 0 && word.sleeping.exchange(0, std::memory_order_relaxed) != 0) {
+            word.epoch.fetch_add(1, std::memory_order_release);
+            futex_wake(word.epoch);
+        }
+#else
+        (void)word;
+#endif
+    }
+
+    // Retries attempt() until it succeeds, waiting between attempts as the strategy says.
+    // word is the futex word that the operation which could make attempt() succeed notifies.
+    template<typename Attempt>
+    void wait_for(Attempt attempt, WaitWord& word) {
+        unsigned spins = 0;
+        while (!attempt()) {
+            if (m_wait == WaitStrategy::Spin || spins < SPINS_BEFORE_WAITING) {
+                spins++;
+#if defined(__x86_64__) || defined(__i386__)
+                __builtin_ia32_pause();
+#endif
+                continue;
+            }
+#ifdef __linux__
+            if (m_wait == WaitStrategy::Futex) {
+                // Announce the sleep, then look once more: either that attempt sees the other thread's
+                // progress, or the other thread sees the flag and bumps the epoch, so the wait returns.
+                uint32_t epoch = word.epoch.load(std::memory_order_acquire);
+                word.sleeping.store(1, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (attempt()) { return; }
+                futex_wait(word.epoch, epoch);
+                continue;
+            }
+#endif
+            std::this_thread::yield();
+        }
+    }
+
+    // Claims the back position and constructs its element from args, unless the queue is full.
+    // The position cannot be given back once claimed, so T must be nothrow constructible from args
+    // (try_emplace and emplace build a temporary T first when it is not).
+    // @returns Returns true if the element was added, false (leaving args untouched) if the queue is full
+    template<typename... Args>
+    bool try_place(Args&&... args) {
+        size_t pos = m_enqueue_pos.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &m_cells[pos & m_mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t lap = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (lap == 0) {
+                // the slot is free for pos; on failure pos is reloaded and we try the new position
+                if (m_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) { break; }
+            }
+            else if (lap < 0) {
+                return false; // the slot still holds the element of the previous lap: full
+            }
+            else {
+                pos = m_enqueue_pos.load(std::memory_order_relaxed); // another producer took pos
+            }
+        }
+        try {
+            new (cell->value()) T(std::forward<Args>(args)...);
+        }
+        catch (...) {
+            // unreachable (the callers only pass args that construct T without throwing): pos is
+            // claimed and a consumer will wait for its element, so it cannot be handed back
+            std::terminate();
+        }
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        notify(m_items);
+        return true;
+    }
+
+    // Claims the front element and passes it to take, which must move it out; then destroys it
+    // and frees its slot for the next lap. Once claimed, the element cannot be given back, so
+    // take must not throw (moving a T out of the queue must not throw).
+    // @returns Returns true if an element was removed, false if the queue is empty
+    template<typename Take>
+    bool try_take(Take take) {
+        size_t pos = m_dequeue_pos.load(std::memory_order_relaxed);
+        Cell* cell;
+        for (;;) {
+            cell = &m_cells[pos & m_mask];
+            size_t sequence = cell->sequence.load(std::memory_order_acquire);
+            intptr_t lap = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+            if (lap == 0) {
+                if (m_dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) { break; }
+            }
+            else if (lap < 0) {
+                return false; // the element for pos has not been written yet: empty
+            }
+            else {
+                pos = m_dequeue_pos.load(std::memory_order_relaxed); // another consumer took pos
+            }
+        }
+        take(*cell->value());
+        cell->value()->~T();
+        cell->sequence.store(pos + m_mask + 1, std::memory_order_release); // free for the next lap
+        notify(m_slots);
+        return true;
+    }
+
+public:
+    // Creates an empty queue holding up to capacity elements (rounded up to a power of two, at least 2).
+    explicit MpmcQueue(size_t capacity, WaitStrategy wait = WaitStrategy::Yield)
+        : m_cells(new Cell[round_up_to_power_of_two(capacity)]), m_mask(round_up_to_power_of_two(capacity) - 1),
+          m_wait(wait), m_enqueue_pos(0), m_dequeue_pos(0), m_items{{0}, {0}}, m_slots{{0}, {0}} {
+        for (size_t i = 0 ; i <= m_mask ; i++) {
+            m_cells[i].sequence.store(i, std::memory_order_relaxed); // slot i is free for position i
+        }
+    }
+
+    // Must not run concurrently with any other member function.
+    ~MpmcQueue() {
+        size_t end = m_enqueue_pos.load(std::memory_order_relaxed);
+        for (size_t pos = m_dequeue_pos.load(std::memory_order_relaxed) ; pos != end ; pos++) {
+            m_cells[pos & m_mask].value()->~T();
+        }
+        delete[] m_cells;
+    }
+
+    // Concurrent containers are shared by reference, not copied.
+    MpmcQueue(const MpmcQueue&) = delete;
+    MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+    size_t capacity() const { return m_mask + 1; }
+
+    // @returns Returns the number of elements; only a snapshot while other threads are running operations
+    size_t size() const {
+        size_t dequeued = m_dequeue_pos.load(std::memory_order_acquire);
+        size_t enqueued = m_enqueue_pos.load(std::memory_order_acquire);
+        return enqueued > dequeued ? enqueued - dequeued : 0;
+    }
+
+    bool isEmpty() const { return size() == 0; }
+
+    // Constructs an element at the back of the queue, unless the queue is full.
+    // If constructing T from args may throw, the element is built before a position is claimed,
+    // so args may have been moved from even when the queue turns out to be full.
+    // @returns Returns true if the element was added, false if the queue is full
+    template<typename... Args>
+    bool try_emplace(Args&&... args) {
+        if constexpr (std::is_nothrow_constructible<T, Args&&...>::value) {
+            return try_place(std::forward<Args>(args)...); // args are untouched if the queue is full
+        }
+        else {
+            T value(std::forward<Args>(args)...);
+            return try_place(std::move(value));
+        }
+    }
+
+    // @returns Returns true if the element was added, false if the queue is full
+    bool try_enqueue(const T& val) { return try_emplace(val); }
+    bool try_enqueue(T&& val) { return try_emplace(std::move(val)); }
+
+    // Constructs an element at the back of the queue, waiting (see WaitStrategy) while the queue is full.
+    template<typename... Args>
+    void emplace(Args&&... args) {
+        if constexpr (std::is_nothrow_constructible<T, Args&&...>::value) {
+            wait_for([&] { return try_place(std::forward<Args>(args)...); }, m_slots);
+        }
+        else {
+            T value(std::forward<Args>(args)...); // built once, before waiting
+            wait_for([&] { return try_place(std::move(value)); }, m_slots);
+        }
+    }
+
+    void enqueue(const T& val) { emplace(val); }
+    void enqueue(T&& val) { emplace(std::move(val)); }
+
+    // Moves the front element into out, unless the queue is empty.
+    // @returns Returns true if an element was removed, false if the queue is empty
+    bool try_dequeue(T& out) {
+        return try_take([&out](T& front) { out = std::move(front); });
+    }
+
+    // Removes the front element, unless the queue is empty. Unlike try_dequeue(out), T needs
+    // neither a default constructor nor move assignment: the result is move-constructed.
+    // @returns Returns the element, or an empty optional if the queue is empty
+    std::optional<T> try_dequeue() {
+        std::optional<T> result;
+        try_take([&result](T& front) { result.emplace(std::move(front)); });
+        return result;
+    }
+
+    // Removes the front element into out, waiting (see WaitStrategy) while the queue is empty.
+    void dequeue(T& out) {
+        wait_for([&] { return try_dequeue(out); }, m_items);
+    }
+
+    // Removes the front element and returns it, waiting (see WaitStrategy) while the queue is empty.
+    T dequeue() {
+        std::optional<T> result;
+        wait_for([&] {
+            return try_take([&result](T& front) { result.emplace(std::move(front)); });
+        }, m_items);
+        return std::move(*result);
+    }
+};
+
+
+// Baseline: a bounded queue guarded by one mutex, with condition variables to wait while full or empty
+template<typename T>
+class MutexQueue {
+private:
+    std::queue<T> m_queue;
+    size_t m_capacity;
+    std::mutex m_lock;
+    std::condition_variable m_not_empty;
+    std::condition_variable m_not_full;
+
+public:
+    explicit MutexQueue(size_t capacity) : m_capacity(capacity) {}
+
+    void enqueue(const T& val) {
+        {
+            std::unique_lock<std::mutex> guard(m_lock);
+            m_not_full.wait(guard, [&] { return m_queue.size() < m_capacity; });
+            m_queue.push(val);
+        }
+        m_not_empty.notify_one();
+    }
+
+    T dequeue() {
+        T value;
+        {
+            std::unique_lock<std::mutex> guard(m_lock);
+            m_not_empty.wait(guard, [&] { return !m_queue.empty(); });
+            value = std::move(m_queue.front());
+            m_queue.pop();
+        }
+        m_not_full.notify_one();
+        return value;
+    }
+};
+
+
+// Runs `threads` producers and `threads` consumers passing total_items integers through queue,
+// and reports the throughput.
+template<typename Queue>
+void benchmarkThroughput(const std::string& name, Queue& queue, size_t threads, size_t total_items) {
+    size_t per_thread = total_items / threads;
+    std::atomic<uint64_t> sum(0);
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (size_t t = 0 ; t < threads ; t++) {
+        workers.emplace_back([&queue, per_thread, t] {
+            for (size_t i = 0 ; i < per_thread ; i++) {
+                queue.enqueue(t * per_thread + i);
+            }
+        });
+        workers.emplace_back([&queue, &sum, per_thread] {
+            uint64_t local = 0;
+            for (size_t i = 0 ; i < per_thread ; i++) {
+                local += queue.dequeue();
+            }
+            sum.fetch_add(local, std::memory_order_relaxed);
+        });
+    }
+    for (std::thread& w : workers) { w.join(); }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    uint64_t n = per_thread * threads;
+    std::cout << threads << " producer(s) + " << threads << " consumer(s), " << name << ": "
+              << n / seconds / 1e6 << " M items/s" << (sum.load() == n * (n - 1) / 2 ? "" : " (WRONG SUM)") << std::endl;
+}
+
+
+int main() {
+    MpmcQueue<std::string> names(3); // capacity 4
+    names.enqueue("first");
+    names.emplace(3, 'x');
+    std::string out;
+    bool got = names.try_dequeue(out);
+    std::cout << "try_dequeue = " << got << " " << out << " | dequeue = " << names.dequeue()
+              << " | try_dequeue on empty = " << names.try_dequeue(out) << " | capacity = " << names.capacity() << std::endl;
+
+    unsigned cpus = std::thread::hardware_concurrency();
+    std::cout << "hardware threads: " << cpus << std::endl;
+    const size_t CAPACITY = 1024;
+    const size_t TOTAL = 1 << 22;
+    for (size_t threads : {1, 2, 4, 8, 16, 32, 64}) {
+        MutexQueue<uint64_t> locked(CAPACITY);
+        benchmarkThroughput("mutex + std::queue", locked, threads, TOTAL);
+        if (2 * threads <= cpus) { // pure spinning only pays off with a core per thread
+            MpmcQueue<uint64_t> spinning(CAPACITY, WaitStrategy::Spin);
+            benchmarkThroughput("MpmcQueue (spin) ", spinning, threads, TOTAL);
+        }
+        MpmcQueue<uint64_t> yielding(CAPACITY, WaitStrategy::Yield);
+        benchmarkThroughput("MpmcQueue (yield)", yielding, threads, TOTAL);
+        MpmcQueue<uint64_t> sleeping(CAPACITY, WaitStrategy::Futex);
+        benchmarkThroughput("MpmcQueue (futex)", sleeping, threads, TOTAL);
+    }
+}
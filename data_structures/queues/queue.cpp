@@ -1,52 +1,109 @@
+/**
+ * FIFO queue stored in a contiguous ring buffer whose capacity is a power of two, so wrapping an
+ * index is a bit mask. The buffer doubles when it is full; enqueue and dequeue never allocate
+ * otherwise, and the bulk operations copy whole ranges (at most two contiguous pieces) at once.
+ */
+
 #include <iostream>
 #include <string>
 #include <sstream>
 #include <stdexcept>
+#include <utility>
+#include <algorithm>
+#include <memory>
+#include <new>
+#include <cstdint>
 
 
 template<typename T>
-struct QueueNode {
+class Queue {
+private:
+    static const size_t MIN_CAPACITY = 8;
 
-    T val;
-    QueueNode* next;
+    T* m_data;      // capacity slots; only the m_size slots starting at m_head hold constructed elements
+    size_t m_mask;  // capacity - 1 (all ones while there is no buffer, so capacity() == 0)
+    size_t m_head;
+    size_t m_size;
 
-    QueueNode() : val(), next(nullptr) {}
-    QueueNode(T val) : val(val), next(nullptr) {}
-    QueueNode(T val, QueueNode<T>* next) : val(val), next(next) {}
+    // returns the slot of the element at position i (0 = front)
+    T* slot(size_t i) const {
+        return m_data + ((m_head + i) & m_mask);
+    }
 
-    // Explicit conversion operator to convert from QueueNode object to a string.
-    // Output of type [ListNode | addr: 0xffff val: {value}].
-    explicit operator std::string() const {
-        std::ostringstream oss;
-        oss << "[QueueNode | addr: " << this << " val: " << this->val << "]\n";
-        return oss.str();
+    // throws std::length_error if the buffer for n elements would not fit in a size_t number of bytes
+    // (doubling the capacity any further would wrap around to 0)
+    static size_t roundUpToPowerOfTwo(size_t n) {
+        size_t capacity = MIN_CAPACITY;
+        while (capacity < n) {
+            if (capacity > SIZE_MAX / sizeof(T) / 2) {
+                throw std::length_error("Queue capacity is too large");
+            }
+            capacity <<= 1;
+        }
+        return capacity;
     }
-};
 
+    // moves the elements, in order, to the start of data (a buffer of at least m_size slots).
+    // if a move throws, the elements already moved are destroyed and the queue is left unchanged
+    void relocate(T* data) {
+        size_t moved = 0;
+        try {
+            for (; moved < m_size; moved++) {
+                new (data + moved) T(std::move_if_noexcept(*slot(moved)));
+            }
+        }
+        catch (...) {
+            std::destroy_n(data, moved);
+            throw;
+        }
+    }
 
-template<typename T>
-class Queue {
-private:
-    QueueNode<T>* head;
-    QueueNode<T>* tail;
+    // replaces the buffer by data, of new_capacity slots, into which the elements have been relocated
+    void adopt(T* data, size_t new_capacity) {
+        size_t count = m_size;
+        clear();
+        m_data = data;
+        m_mask = new_capacity - 1;
+        m_size = count;
+    }
+
+    void reallocate(size_t new_capacity) {
+        T* data = static_cast<T*>(::operator new(new_capacity * sizeof(T)));
+        try {
+            relocate(data);
+        }
+        catch (...) {
+            ::operator delete(data);
+            throw;
+        }
+        adopt(data, new_capacity);
+    }
+
+    // destroys all elements and frees the buffer
+    void clear() {
+        for (size_t i = 0; i < m_size; i++) {
+            slot(i)->~T();
+        }
+        ::operator delete(m_data);
+        m_data = nullptr;
+        m_mask = size_t(-1);
+        m_head = 0;
+        m_size = 0;
+    }
 
 public:
-    Queue() : head(nullptr), tail(nullptr) {}
+    Queue() : m_data(nullptr), m_mask(size_t(-1)), m_head(0), m_size(0) {}
 
     ~Queue() {
-        while (head != nullptr) {
-            QueueNode<T>* tmp = head->next;
-            delete head;
-            head = tmp;
-        }
+        clear();
     }
 
     // copy constructor
-    Queue(const Queue& other) : head(nullptr), tail(nullptr) {
-        QueueNode<T>* current = other.head;
-        while (current != nullptr) {
-            enqueue(current->val);
-            current = current->next;
+    Queue(const Queue& other) : Queue() {
+        reserve(other.m_size);
+        for (size_t i = 0; i < other.m_size; i++) {
+            new (m_data + i) T(*other.slot(i));
+            m_size++;
         }
     }
 
@@ -59,63 +116,140 @@ public:
         return *this;
     }
 
-    // adds an element to the back of the queue
-    void enqueue(T val) {
-        QueueNode<T>* tmp = new QueueNode<T>(val);
-        if (tail == nullptr) { // Queue is empty
-            head = tmp;
-            tail = tmp;
+    // move constructor: takes over the buffer of other, which is left empty with no buffer
+    Queue(Queue&& other) noexcept : m_data(other.m_data), m_mask(other.m_mask), m_head(other.m_head), m_size(other.m_size) {
+        other.m_data = nullptr;
+        other.m_mask = size_t(-1);
+        other.m_head = 0;
+        other.m_size = 0;
+    }
+
+    // move assignment operator
+    Queue& operator=(Queue&& other) noexcept {
+        if (this != &other) {
+            Queue tmp(std::move(other)); // tmp frees our old buffer
+            swap(tmp);
         }
-        else {
-            tail->next = tmp;
-            tail = tail->next;
+        return *this;
+    }
+
+    // adds an element to the back of the queue
+    void enqueue(const T& val) {
+        emplace(val);
+    }
+
+    void enqueue(T&& val) {
+        emplace(std::move(val));
+    }
+
+    // constructs an element in place at the back of the queue
+    // @returns a reference to the new element
+    template<typename... Args>
+    T& emplace(Args&&... args) {
+        if (m_size == capacity()) {
+            // the new element is constructed before the old ones are moved, since args may refer to one of them
+            size_t new_capacity = roundUpToPowerOfTwo(m_size + 1);
+            T* data = static_cast<T*>(::operator new(new_capacity * sizeof(T)));
+            try {
+                new (data + m_size) T(std::forward<Args>(args)...);
+                try {
+                    relocate(data);
+                }
+                catch (...) {
+                    data[m_size].~T();
+                    throw;
+                }
+            }
+            catch (...) {
+                ::operator delete(data);
+                throw;
+            }
+            adopt(data, new_capacity);
+            return data[m_size++];
         }
+        T* dst = slot(m_size);
+        new (dst) T(std::forward<Args>(args)...);
+        m_size++;
+        return *dst;
+    }
+
+    // adds n elements to the back of the queue, in order, growing the buffer at most once.
+    // values must not point into this queue
+    void enqueue_bulk(const T* values, size_t n) {
+        reserve(m_size + n);
+        size_t tail = (m_head + m_size) & m_mask;
+        size_t first = std::min(n, capacity() - tail); // the rest wraps around to the start of the buffer
+        std::uninitialized_copy(values, values + first, m_data + tail);
+        m_size += first;
+        std::uninitialized_copy(values + first, values + n, m_data);
+        m_size += n - first;
     }
 
-    // removes the first element of the queue
+    // removes the first element of the queue and returns it (moved out, not copied)
     // @throws out_of_range error if queue is empty
     T dequeue() {
-        if (head == nullptr) {
+        if (m_size == 0) {
             throw std::out_of_range("Called dequeue on empty queue");
         }
-        QueueNode<T>* tmp = head;
-        T value = head->val;
-        head = head->next;
-        if (head == nullptr) { // Queue becomes empty
-            tail = nullptr;
-        }
-        delete tmp;
+        T* front = slot(0);
+        T value = std::move(*front);
+        front->~T();
+        m_head = (m_head + 1) & m_mask;
+        m_size--;
         return value;
     }
 
+    // removes up to n elements from the front of the queue, moving them in order into out[0..n)
+    // @returns the number of elements removed (less than n if the queue runs out)
+    size_t dequeue_bulk(T* out, size_t n) {
+        size_t count = std::min(n, m_size);
+        size_t first = std::min(count, capacity() - m_head);
+        std::move(m_data + m_head, m_data + m_head + first, out);
+        std::destroy_n(m_data + m_head, first);
+        std::move(m_data, m_data + (count - first), out + first);
+        std::destroy_n(m_data, count - first);
+        m_head = (m_head + count) & m_mask;
+        m_size -= count;
+        return count;
+    }
+
+    // returns the number of elements in the queue (O(1))
     int size() const {
-        if (head == nullptr) {
-            return 0;
-        }
-        int counter = 0;
-        QueueNode<T>* curr = head;
-        while (curr != nullptr) {
-            curr = curr->next;
-            counter++;
+        return static_cast<int>(m_size);
+    }
+
+    bool isEmpty() const {
+        return m_size == 0;
+    }
+
+    size_t capacity() const {
+        return m_mask + 1;
+    }
+
+    // makes room for at least n elements (rounded up to a power of two)
+    // @throws length_error if n elements can never fit in memory
+    void reserve(size_t n) {
+        if (n > capacity()) {
+            reallocate(roundUpToPowerOfTwo(n));
         }
-        return counter;
     }
 
     void print() const {
-        QueueNode<T>* curr = head;
         std::cout << "Queue{\n";
-        while (curr != nullptr) {
-            std::cout << "    " << static_cast<std::string>(*curr);
-            curr = curr->next;
+        for (size_t i = 0; i < m_size; i++) {
+            std::ostringstream oss;
+            oss << "    [QueueSlot | slot: " << ((m_head + i) & m_mask) << " val: " << *slot(i) << "]\n";
+            std::cout << oss.str();
         }
         std::cout << "}" << std::endl;
     }
 
     // Helper function
     void swap(Queue& other) noexcept {
-        std::swap(head, other.head);
-        std::swap(tail, other.tail);
+        std::swap(m_data, other.m_data);
+        std::swap(m_mask, other.m_mask);
+        std::swap(m_head, other.m_head);
+        std::swap(m_size, other.m_size);
     }
 
 };
-
@@ -0,0 +1,381 @@
+/**
+ * A bounded lock-free queue connecting exactly one producer thread to exactly one consumer thread.
+ * The elements live in a power-of-two ring buffer. The producer only writes the tail index and the
+ * consumer only writes the head index, so neither side ever takes a lock or does a read-modify-write:
+ * an element is published by a release store of the index and picked up by an acquire load of it.
+ * Each index has its own cache line, along with the owning thread's cached copy of the other index,
+ * which it re-reads only when the queue looks full (or empty) by the cached copy.
+ */
+
+#include <iostream>
+#include <vector>
+#include <queue>
+#include <string>
+#include <utility>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <new>
+#include <cstdint>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+
+template<typename T>
+class SpscQueue {
+private:
+    static const size_t CACHE_LINE = 64;
+
+    // Indices count elements since construction and are only masked when a slot is accessed,
+    // so tail - head is always the number of elements and a full queue is not confused with an empty one.
+    struct alignas(CACHE_LINE) ProducerIndex {
+        std::atomic<size_t> tail; // next slot to write; stored by the producer only
+        size_t cached_head;       // the producer's last read of head (a lower bound of it)
+    };
+
+    struct alignas(CACHE_LINE) ConsumerIndex {
+        std::atomic<size_t> head; // next slot to read; stored by the consumer only
+        size_t cached_tail;       // the consumer's last read of tail (a lower bound of it)
+    };
+
+    T* const m_data;    // never written after construction, so it can share a line with m_mask
+    const size_t m_mask;
+    ProducerIndex m_producer;
+    ConsumerIndex m_consumer;
+
+    static size_t round_up_to_power_of_two(size_t n) {
+        size_t capacity = 1;
+        while (capacity < n) { capacity <<= 1; }
+        return capacity;
+    }
+
+    T* slot(size_t idx) const { return m_data + (idx & m_mask); }
+
+    // @returns Returns how many elements the producer can write without waiting, looking at the real head
+    // only if the cached one shows fewer than wanted
+    size_t free_slots(size_t tail, size_t wanted) {
+        size_t free = capacity() - (tail - m_producer.cached_head);
+        if (free < wanted) {
+            m_producer.cached_head = m_consumer.head.load(std::memory_order_acquire);
+            free = capacity() - (tail - m_producer.cached_head);
+        }
+        return free;
+    }
+
+    // @returns Returns how many elements the consumer can read without waiting, looking at the real tail
+    // only if the cached one shows fewer than wanted
+    size_t available(size_t head, size_t wanted) {
+        size_t ready = m_consumer.cached_tail - head;
+        if (ready < wanted) {
+            m_consumer.cached_tail = m_producer.tail.load(std::memory_order_acquire);
+            ready = m_consumer.cached_tail - head;
+        }
+        return ready;
+    }
+
+public:
+    // Spins briefly, then yields, so that a waiting thread does not starve the thread it is waiting
+    // for when the two share a core.
+    static void backoff(unsigned& spins) {
+        if (spins++ < 64) {
+#if defined(__x86_64__) || defined(__i386__)
+            __builtin_ia32_pause();
+#endif
+        }
+        else {
+            std::this_thread::yield();
+        }
+    }
+
+    // Creates an empty queue holding up to capacity elements (rounded up to a power of two).
+    explicit SpscQueue(size_t capacity)
+        : m_data(static_cast<T*>(::operator new(round_up_to_power_of_two(capacity) * sizeof(T)))),
+          m_mask(round_up_to_power_of_two(capacity) - 1), m_producer{{0}, 0}, m_consumer{{0}, 0} {}
+
+    // Must not run concurrently with any other member function.
+    ~SpscQueue() {
+        size_t tail = m_producer.tail.load(std::memory_order_relaxed);
+        for (size_t i = m_consumer.head.load(std::memory_order_relaxed) ; i != tail ; i++) {
+            slot(i)->~T();
+        }
+        ::operator delete(m_data);
+    }
+
+    // Concurrent containers are shared by reference, not copied.
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    size_t capacity() const { return m_mask + 1; }
+
+    // @returns Returns the number of elements; exact only when neither thread is running an operation.
+    // May be called from any thread.
+    size_t size() const {
+        size_t head = m_consumer.head.load(std::memory_order_acquire); // head first, so that tail >= head
+        return m_producer.tail.load(std::memory_order_acquire) - head;
+    }
+
+    bool isEmpty() const { return size() == 0; }
+
+    // ---- producer side: only one thread may call these ----
+
+    // Constructs an element at the back of the queue, unless the queue is full.
+    // @returns Returns true if the element was added, false (leaving args untouched) if the queue is full
+    template<typename... Args>
+    bool try_emplace(Args&&... args) {
+        size_t tail = m_producer.tail.load(std::memory_order_relaxed);
+        if (free_slots(tail, 1) == 0) { return false; }
+        new (slot(tail)) T(std::forward<Args>(args)...);
+        m_producer.tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_enqueue(const T& val) { return try_emplace(val); }
+    bool try_enqueue(T&& val) { return try_emplace(std::move(val)); }
+
+    // Constructs an element at the back of the queue, waiting while the queue is full.
+    template<typename... Args>
+    void emplace(Args&&... args) {
+        unsigned spins = 0;
+        while (!try_emplace(std::forward<Args>(args)...)) { backoff(spins); }
+    }
+
+    void enqueue(const T& val) { emplace(val); }
+    void enqueue(T&& val) { emplace(std::move(val)); }
+
+    // Copies as many of values[0..n) as there is room for to the back of the queue,
+    // publishing them all with one store.
+    // @returns Returns the number of elements added (a prefix of values)
+    size_t try_enqueue_bulk(const T* values, size_t n) {
+        size_t tail = m_producer.tail.load(std::memory_order_relaxed);
+        size_t count = std::min(n, free_slots(tail, n));
+        size_t i = 0;
+        try {
+            for (; i < count ; i++) { new (slot(tail + i)) T(values[i]); }
+        }
+        catch (...) {
+            m_producer.tail.store(tail + i, std::memory_order_release); // publish the ones already copied
+            throw;
+        }
+        m_producer.tail.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+    // Copies values[0..n) to the back of the queue, waiting for room whenever it is full.
+    void enqueue_bulk(const T* values, size_t n) {
+        unsigned spins = 0;
+        while (n > 0) {
+            size_t added = try_enqueue_bulk(values, n);
+            if (added == 0) {
+                backoff(spins);
+                continue;
+            }
+            spins = 0;
+            values += added;
+            n -= added;
+        }
+    }
+
+    // ---- consumer side: only one thread may call these ----
+
+    // Moves the front element into out, unless the queue is empty.
+    // @returns Returns true if an element was removed, false if the queue is empty
+    bool try_dequeue(T& out) {
+        size_t head = m_consumer.head.load(std::memory_order_relaxed);
+        if (available(head, 1) == 0) { return false; }
+        T* front = slot(head);
+        out = std::move(*front);
+        front->~T();
+        m_consumer.head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Removes the front element and returns it (moved out), waiting while the queue is empty.
+    T dequeue() {
+        size_t head = m_consumer.head.load(std::memory_order_relaxed);
+        unsigned spins = 0;
+        while (available(head, 1) == 0) { backoff(spins); }
+        T* front = slot(head);
+        T value = std::move(*front);
+        front->~T();
+        m_consumer.head.store(head + 1, std::memory_order_release);
+        return value;
+    }
+
+    // Moves up to n elements from the front of the queue into out[0..n), in order,
+    // releasing their slots with one store. If a move throws, the elements already moved out are
+    // removed and the one that threw stays at the front of the queue.
+    // @returns Returns the number of elements removed
+    size_t try_dequeue_bulk(T* out, size_t n) {
+        size_t head = m_consumer.head.load(std::memory_order_relaxed);
+        size_t count = std::min(n, available(head, n));
+        size_t i = 0;
+        try {
+            for (; i < count ; i++) {
+                T* src = slot(head + i);
+                out[i] = std::move(*src);
+                src->~T();
+            }
+        }
+        catch (...) {
+            m_consumer.head.store(head + i, std::memory_order_release); // release the slots already destroyed
+            throw;
+        }
+        m_consumer.head.store(head + count, std::memory_order_release);
+        return count;
+    }
+
+    // Moves n elements from the front of the queue into out[0..n), waiting whenever it is empty.
+    void dequeue_bulk(T* out, size_t n) {
+        unsigned spins = 0;
+        while (n > 0) {
+            size_t removed = try_dequeue_bulk(out, n);
+            if (removed == 0) {
+                backoff(spins);
+                continue;
+            }
+            spins = 0;
+            out += removed;
+            n -= removed;
+        }
+    }
+};
+
+
+// Pins the calling thread to one CPU, so the benchmark threads stay on their cores.
+// @returns Returns false if the thread could not be pinned (or pinning is not supported)
+bool pinToCpu(unsigned cpu) {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+// Measures hand-off latency by ping-pong: the main thread sends a value to an echo thread, which
+// sends it straight back through a second queue. A one-way hand-off is half a round trip.
+// Prints a histogram of the one-way latencies, with power-of-two buckets, and some percentiles.
+void benchmarkLatency(size_t rounds, bool pin) {
+    SpscQueue<uint64_t> ping(64), pong(64);
+    std::thread echo([&] {
+        if (pin) { pinToCpu(1); }
+        for (size_t i = 0 ; i < rounds ; i++) {
+            pong.enqueue(ping.dequeue());
+        }
+    });
+    if (pin) { pinToCpu(0); }
+
+    std::vector<double> one_way(rounds);
+    for (size_t i = 0 ; i < rounds ; i++) {
+        auto start = std::chrono::steady_clock::now();
+        ping.enqueue(i);
+        pong.dequeue();
+        one_way[i] = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / 2;
+    }
+    echo.join();
+
+    const size_t BUCKETS = 24; // bucket b holds [2^b, 2^(b+1)) ns; the last one everything above
+    std::vector<size_t> histogram(BUCKETS);
+    for (double ns : one_way) {
+        size_t b = 0;
+        while (b + 1 < BUCKETS && ns >= double(size_t(2) << b)) { b++; }
+        histogram[b]++;
+    }
+    std::cout << "one-way hand-off latency, " << rounds << " round trips" << (pin ? ", threads pinned" : "") << ":\n";
+    for (size_t b = 0 ; b < BUCKETS ; b++) {
+        if (histogram[b] == 0) { continue; }
+        std::cout << "  [" << (size_t(1) << b) << ", " << (size_t(2) << b) << ") ns: "
+                  << std::string(std::max<size_t>(1, histogram[b] * 50 / rounds), '#') << " " << histogram[b] << "\n";
+    }
+    std::sort(one_way.begin(), one_way.end());
+    std::cout << "  p50 " << one_way[rounds / 2] << " ns, p99 " << one_way[rounds * 99 / 100]
+              << " ns, p99.9 " << one_way[rounds * 999 / 1000] << " ns" << std::endl;
+}
+
+// Streams total_items integers from a producer to a consumer, one at a time or in batches,
+// and reports the throughput.
+void benchmarkThroughput(size_t total_items, size_t batch) {
+    SpscQueue<uint64_t> queue(1024);
+    auto start = std::chrono::steady_clock::now();
+    std::thread producer([&] {
+        std::vector<uint64_t> values(batch);
+        for (size_t i = 0 ; i < total_items ; i += batch) {
+            if (batch == 1) {
+                queue.enqueue(i);
+                continue;
+            }
+            for (size_t j = 0 ; j < batch ; j++) { values[j] = i + j; }
+            queue.enqueue_bulk(values.data(), batch);
+        }
+    });
+
+    uint64_t sum = 0;
+    std::vector<uint64_t> out(batch);
+    for (size_t i = 0 ; i < total_items ; i += batch) {
+        if (batch == 1) {
+            sum += queue.dequeue();
+            continue;
+        }
+        queue.dequeue_bulk(out.data(), batch);
+        for (uint64_t v : out) { sum += v; }
+    }
+    producer.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "SpscQueue, batch " << batch << ": " << total_items / seconds / 1e6 << " M items/s"
+              << (sum == uint64_t(total_items) * (total_items - 1) / 2 ? "" : " (WRONG SUM)") << std::endl;
+}
+
+// Baseline: the same stream through a mutex-guarded queue
+void benchmarkMutexBaseline(size_t total_items) {
+    std::queue<uint64_t> queue;
+    std::mutex lock;
+    auto start = std::chrono::steady_clock::now();
+    std::thread producer([&] {
+        for (size_t i = 0 ; i < total_items ; i++) {
+            std::lock_guard<std::mutex> guard(lock);
+            queue.push(i);
+        }
+    });
+
+    uint64_t sum = 0;
+    for (size_t received = 0 ; received < total_items ; ) {
+        std::lock_guard<std::mutex> guard(lock);
+        while (!queue.empty()) {
+            sum += queue.front();
+            queue.pop();
+            received++;
+        }
+    }
+    producer.join();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "mutex + std::queue: " << total_items / seconds / 1e6 << " M items/s"
+              << (sum == uint64_t(total_items) * (total_items - 1) / 2 ? "" : " (WRONG SUM)") << std::endl;
+}
+
+
+int main() {
+    SpscQueue<std::string> names(3); // capacity 4
+    names.enqueue("first");
+    names.emplace(3, 'x');
+    std::string out;
+    bool got = names.try_dequeue(out);
+    std::cout << "try_dequeue = " << got << " " << out << " | dequeue = " << names.dequeue()
+              << " | size = " << names.size() << " | capacity = " << names.capacity() << std::endl;
+
+    unsigned cpus = std::thread::hardware_concurrency();
+    std::cout << "hardware threads: " << cpus << std::endl;
+    benchmarkLatency(200000, cpus >= 2);
+
+    const size_t TOTAL = 1 << 24;
+    benchmarkMutexBaseline(TOTAL);
+    benchmarkThroughput(TOTAL, 1);
+    benchmarkThroughput(TOTAL, 64);
+}
@@ -0,0 +1,343 @@
+/**
+ * Chase-Lev work-stealing deque, the per-worker task queue of a work-stealing scheduler.
+ * The owning worker pushes and pops at the bottom (LIFO, so it keeps working on the freshest,
+ * cache-hot tasks) without any read-modify-write except when one element is left; other workers
+ * steal from the top (FIFO, taking the oldest and usually largest tasks) with one compare-exchange.
+ * Elements live in a power-of-two circular array which the owner replaces by one twice as large
+ * when it is full. A thief may still be reading an old array, so old arrays are only freed with
+ * the deque. Memory orderings follow Le, Pop, Cohen and Zappa Nardelli, "Correct and Efficient
+ * Work-Stealing for Weak Memory Models" (PPoPP 2013).
+ */
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <utility>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <cstdint>
+
+
+template<typename T>
+class WorkStealingDeque {
+    // A thief reads an element before it knows whether its steal wins, possibly while the owner
+    // overwrites the slot, so elements are atomics and must be trivially copyable (typically task pointers).
+    static_assert(std::is_trivially_copyable<T>::value, "WorkStealingDeque elements must be trivially copyable");
+
+private:
+    static const size_t CACHE_LINE = 64;
+
+    struct Array {
+        const int64_t capacity;
+        std::unique_ptr<std::atomic<T>[]> cells;
+
+        explicit Array(int64_t c) : capacity(c), cells(new std::atomic<T>[c]) {}
+
+        T get(int64_t i) const { return cells[i & (capacity - 1)].load(std::memory_order_relaxed); }
+        void put(int64_t i, T val) { cells[i & (capacity - 1)].store(val, std::memory_order_relaxed); }
+    };
+
+    // top only grows (by successful steals, and by pop taking the last element);
+    // bottom is written by the owner only. The elements are those at [top, bottom).
+    alignas(CACHE_LINE) std::atomic<int64_t> m_top;
+    alignas(CACHE_LINE) std::atomic<int64_t> m_bottom;
+    alignas(CACHE_LINE) std::atomic<Array*> m_array;
+    std::vector<std::unique_ptr<Array>> m_arrays; // the current array and all replaced ones; owner only
+
+    static int64_t round_up_to_power_of_two(size_t n) {
+        int64_t capacity = 2;
+        while (static_cast<size_t>(capacity) < n) { capacity <<= 1; }
+        return capacity;
+    }
+
+    // Copies the elements at [top, bottom) into an array twice as large and publishes it.
+    Array* grow(Array* old, int64_t top, int64_t bottom) {
+        m_arrays.emplace_back(new Array(old->capacity * 2));
+        Array* bigger = m_arrays.back().get();
+        for (int64_t i = top ; i < bottom ; i++) {
+            bigger->put(i, old->get(i));
+        }
+        m_array.store(bigger, std::memory_order_release);
+        return bigger;
+    }
+
+public:
+    // Creates an empty deque with room for capacity elements before it first grows.
+    explicit WorkStealingDeque(size_t capacity = 64) : m_top(0), m_bottom(0) {
+        m_arrays.emplace_back(new Array(round_up_to_power_of_two(capacity)));
+        m_array.store(m_arrays.back().get(), std::memory_order_relaxed);
+    }
+
+    // Concurrent containers are shared by reference, not copied.
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    // @returns Returns the number of elements; only a snapshot while other threads are running operations
+    size_t size() const {
+        int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+        int64_t top = m_top.load(std::memory_order_relaxed);
+        return bottom > top ? static_cast<size_t>(bottom - top) : 0;
+    }
+
+    bool isEmpty() const { return size() == 0; }
+
+    // Pushes an element at the bottom. Owner only.
+    void push(T val) {
+        int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+        int64_t top = m_top.load(std::memory_order_acquire);
+        Array* array = m_array.load(std::memory_order_relaxed);
+        if (bottom - top > array->capacity - 1) {
+            array = grow(array, top, bottom);
+        }
+        array->put(bottom, val);
+        std::atomic_thread_fence(std::memory_order_release); // the element is visible before the new bottom
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+
+    // Pops the element at the bottom (the most recently pushed one). Owner only.
+    // @returns Returns true and stores the element in out, or false if the deque is empty
+    bool pop(T& out) {
+        int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+        Array* array = m_array.load(std::memory_order_relaxed);
+        m_bottom.store(bottom, std::memory_order_relaxed);
+        // Claim the slot before looking at top: a thief reads top before bottom, so one of the two
+        // sees the other's update (both fences are seq_cst).
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t top = m_top.load(std::memory_order_relaxed);
+
+        if (top > bottom) { // empty
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+            return false;
+        }
+        T val = array->get(bottom);
+        if (top == bottom) {
+            // The last element: thieves may be after it too, so take it the way they do, by moving top.
+            bool won = m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            m_bottom.store(bottom + 1, std::memory_order_relaxed);
+            if (!won) { return false; }
+        }
+        out = val;
+        return true;
+    }
+
+    // Steals the element at the top (the oldest one). Any thread other than the owner.
+    // @returns Returns true and stores the element in out; false if the deque is empty or another
+    // thread took the element first (the caller may simply try again, or try another deque)
+    bool steal(T& out) {
+        int64_t top = m_top.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t bottom = m_bottom.load(std::memory_order_acquire);
+        if (top >= bottom) { return false; }
+
+        Array* array = m_array.load(std::memory_order_acquire);
+        T val = array->get(top);
+        if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return false;
+        }
+        out = val;
+        return true;
+    }
+};
+
+
+// Pushes and pops items on one deque while `thieves` threads steal from it, and checks that
+// every item comes out exactly once. A small initial capacity makes the array grow under contention.
+bool stressTest(size_t thieves, int items, int rounds) {
+    for (int round = 0 ; round < rounds ; round++) {
+        WorkStealingDeque<int> deque(2);
+        std::vector<std::atomic<int>> taken(items);
+        for (std::atomic<int>& t : taken) { t.store(0, std::memory_order_relaxed); }
+        std::atomic<int> remaining(items);
+
+        std::vector<std::thread> stealers;
+        for (size_t s = 0 ; s < thieves ; s++) {
+            stealers.emplace_back([&] {
+                int item;
+                while (remaining.load(std::memory_order_relaxed) > 0) {
+                    if (deque.steal(item)) {
+                        taken[item].fetch_add(1, std::memory_order_relaxed);
+                        remaining.fetch_sub(1, std::memory_order_relaxed);
+                    }
+                    else {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+
+        // The owner pushes in bursts and pops part of each burst, as a scheduler's worker does.
+        uint32_t rng = 12345 + round;
+        int item;
+        for (int next = 0 ; next < items ; ) {
+            rng = rng * 1103515245 + 12345;
+            int burst = std::min<int>(1 + (rng >> 16) % 64, items - next);
+            for (int i = 0 ; i < burst ; i++) { deque.push(next++); }
+            for (int i = 0 ; i < burst / 2 && deque.pop(item) ; i++) {
+                taken[item].fetch_add(1, std::memory_order_relaxed);
+                remaining.fetch_sub(1, std::memory_order_relaxed);
+            }
+        }
+        while (deque.pop(item)) {
+            taken[item].fetch_add(1, std::memory_order_relaxed);
+            remaining.fetch_sub(1, std::memory_order_relaxed);
+        }
+        for (std::thread& s : stealers) { s.join(); }
+
+        for (int i = 0 ; i < items ; i++) {
+            if (taken[i].load() != 1) {
+                std::cout << "stress test FAILED: item " << i << " taken " << taken[i].load() << " times" << std::endl;
+                return false;
+            }
+        }
+    }
+    std::cout << "stress test passed: " << thieves << " thieves, " << rounds << " rounds of " << items << " items" << std::endl;
+    return true;
+}
+
+
+// A binary search tree node laid out like AVLTree::Node (AVL_tree.cpp), whose root is not exposed
+struct TreeNode {
+    int64_t val;
+    TreeNode* left;
+    TreeNode* right;
+    int height;
+};
+
+// Builds the balanced tree of the values [lo, hi) (the shape an AVL tree of them has at best).
+TreeNode* buildTree(int64_t lo, int64_t hi) {
+    if (lo >= hi) { return nullptr; }
+    int64_t mid = lo + (hi - lo) / 2;
+    TreeNode* node = new TreeNode{mid, buildTree(lo, mid), buildTree(mid + 1, hi), 1};
+    node->height = 1 + std::max(node->left ? node->left->height : 0, node->right ? node->right->height : 0);
+    return node;
+}
+
+void freeTree(TreeNode* node) {
+    if (node == nullptr) { return; }
+    freeTree(node->left);
+    freeTree(node->right);
+    delete node;
+}
+
+int64_t sequentialSum(const TreeNode* node) {
+    if (node == nullptr) { return 0; }
+    return node->val + sequentialSum(node->left) + sequentialSum(node->right);
+}
+
+
+// Fork-join tree sum on a work-stealing pool: one WorkStealingDeque per worker. Summing a node forks
+// its left subtree as a task on the worker's own deque, sums the right subtree itself, then joins:
+// until the left task is done it pops tasks from its own deque, or steals from other workers, and runs them.
+class ParallelTreeSum {
+private:
+    // subtrees this small are summed without forking
+    static const int SEQUENTIAL_HEIGHT = 10;
+
+    struct SumTask {
+        const TreeNode* node;
+        int64_t result;
+        std::atomic<bool> done;
+    };
+
+    std::vector<std::unique_ptr<WorkStealingDeque<SumTask*>>> m_deques;
+    std::atomic<bool> m_finished;
+
+    // Steals a task from a random other worker.
+    bool stealTask(size_t self, uint32_t& rng, SumTask*& task) {
+        size_t workers = m_deques.size();
+        if (workers < 2) { return false; }
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        size_t victim = (self + 1 + rng % (workers - 1)) % workers;
+        return m_deques[victim]->steal(task);
+    }
+
+    void run(SumTask* task, size_t self, uint32_t& rng) {
+        task->result = sum(task->node, self, rng);
+        task->done.store(true, std::memory_order_release);
+    }
+
+    int64_t sum(const TreeNode* node, size_t self, uint32_t& rng) {
+        if (node == nullptr) { return 0; }
+        if (node->height <= SEQUENTIAL_HEIGHT) { return sequentialSum(node); }
+
+        SumTask left{node->left, 0, {false}};
+        m_deques[self]->push(&left);
+        int64_t right = sum(node->right, self, rng);
+
+        SumTask* task;
+        while (!left.done.load(std::memory_order_acquire)) {
+            if (m_deques[self]->pop(task) || stealTask(self, rng, task)) {
+                run(task, self, rng); // usually left itself, unless a thief took it
+            }
+            else {
+                std::this_thread::yield();
+            }
+        }
+        return node->val + left.result + right;
+    }
+
+public:
+    explicit ParallelTreeSum(size_t workers) : m_finished(false) {
+        for (size_t w = 0 ; w < workers ; w++) {
+            m_deques.emplace_back(new WorkStealingDeque<SumTask*>());
+        }
+    }
+
+    // The calling thread is worker 0; the others only steal until the sum is done.
+    int64_t operator()(const TreeNode* root) {
+        m_finished.store(false, std::memory_order_relaxed);
+        std::vector<std::thread> helpers;
+        for (size_t w = 1 ; w < m_deques.size() ; w++) {
+            helpers.emplace_back([this, w] {
+                uint32_t rng = 2463534242u + static_cast<uint32_t>(w);
+                SumTask* task;
+                while (!m_finished.load(std::memory_order_acquire)) {
+                    if (stealTask(w, rng, task)) { run(task, w, rng); }
+                    else { std::this_thread::yield(); }
+                }
+            });
+        }
+        uint32_t rng = 2463534242u;
+        int64_t total = sum(root, 0, rng);
+        m_finished.store(true, std::memory_order_release);
+        for (std::thread& h : helpers) { h.join(); }
+        return total;
+    }
+};
+
+
+int main() {
+    WorkStealingDeque<int> deque(4);
+    for (int i = 0 ; i < 6 ; i++) { deque.push(i); } // grows to capacity 8
+    int popped = -1, stolen = -1;
+    deque.pop(popped);
+    deque.steal(stolen);
+    std::cout << "pop = " << popped << " | steal = " << stolen << " | size = " << deque.size() << std::endl;
+
+    unsigned cpus = std::thread::hardware_concurrency();
+    std::cout << "hardware threads: " << cpus << std::endl;
+    bool ok = stressTest(1, 200000, 20) && stressTest(3, 200000, 20) && stressTest(7, 200000, 10);
+    if (!ok) { return 1; }
+
+    const int64_t N = int64_t(1) << 21;
+    TreeNode* root = buildTree(0, N);
+    const int REPEATS = 10;
+    double base = 0;
+    for (size_t workers = 1 ; workers <= std::max<size_t>(cpus, 4) ; workers *= 2) {
+        ParallelTreeSum parallelSum(workers);
+        int64_t total = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (int r = 0 ; r < REPEATS ; r++) { total = parallelSum(root); }
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() / REPEATS;
+        if (workers == 1) { base = ms; }
+        std::cout << "tree sum of " << N << " nodes, " << workers << " worker(s): " << ms << " ms, speedup "
+                  << base / ms << (total == N * (N - 1) / 2 ? "" : " (WRONG SUM)") << std::endl;
+    }
+    freeTree(root);
+}
@@ -2,6 +2,7 @@
 #include <stdexcept>
 #include <string>
 #include <sstream>
+#include <utility>
 
 
 template<typename T>
@@ -12,6 +13,10 @@ struct Node {
     Node(const T& val) : val(val), next(nullptr) {}
     Node(const T& val, Node<T>* next) : val(val), next(next) {}
 
+    // Constructs the value in place from args.
+    template<typename... Args>
+    Node(std::in_place_t, Node<T>* next, Args&&... args) : val(std::forward<Args>(args)...), next(next) {}
+
     // Explicit conversion operator to convert from QueueNode object to a string.
     // Output of type [StackItem | addr: 0xffff val: {value}].
     explicit operator std::string() const {
@@ -40,11 +45,53 @@ public:
         }
     }
 
+    // copy constructor (deep copy, keeping the order of the elements)
+    Stack(const Stack& other) : Stack() {
+        Node<T>** link = &head;
+        for (const Node<T>* curr = other.head; curr != nullptr; curr = curr->next) {
+            *link = new Node<T>(curr->val);
+            link = &(*link)->next;
+        }
+    }
+
+    // assignment operator
+    Stack& operator=(const Stack& other) {
+        if (this != &other) {
+            Stack tmp(other);
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    // move constructor: takes over the nodes of other, which is left empty
+    Stack(Stack&& other) noexcept : head(other.head) {
+        other.head = nullptr;
+    }
+
+    // move assignment operator
+    Stack& operator=(Stack&& other) noexcept {
+        if (this != &other) {
+            Stack tmp(std::move(other)); // tmp frees our old nodes
+            swap(tmp);
+        }
+        return *this;
+    }
+
     // push an element onto the stack
     void push(const T& val) {
-        Node<T>* newNode = new Node<T>(val);
-        newNode->next = head;
-        head = newNode;
+        emplace(val);
+    }
+
+    void push(T&& val) {
+        emplace(std::move(val));
+    }
+
+    // construct an element in place on top of the stack
+    // @returns a reference to the new top element
+    template<typename... Args>
+    T& emplace(Args&&... args) {
+        head = new Node<T>(std::in_place, head, std::forward<Args>(args)...);
+        return head->val;
     }
 
     // remove an element from the top of the stack
@@ -56,6 +103,15 @@ public:
         head = head->next;
         delete tmp; // deallocate the memory used by the top node
     }
+
+    // remove the top element, moving its value into out
+    // @throws runtime_error if stack is empty
+    void pop(T& out) {
+        if (this->isEmpty()) { throw std::runtime_error("Attempted to pop from empty stack"); }
+
+        out = std::move(head->val);
+        pop();
+    }
     
     // returns the value of the top element
     // @throws runtime_error if stack is empty
@@ -84,4 +140,9 @@ public:
 
         std::cout << "}" << std::endl;
     }
+
+    // helper function to swap the contents of two stacks
+    void swap(Stack& other) noexcept {
+        std::swap(head, other.head);
+    }
 };
\ No newline at end of file